@@ -0,0 +1,185 @@
+//
+// AlarmEventQueue.c
+//
+// OCAP - Open Collision Avoidance Protocol
+//
+// Queue of alarm events for an asynchronous consumer.
+//
+// 17.10.2026 ASR  First version.
+//
+// Software License (BSD):
+// Copyright 2026 Classy Code GmbH.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contribu-
+//    tors may be used to endorse or promote products derived from this soft-
+//    ware without specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS “AS IS”
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+
+#include "AlarmEventQueue.h"
+#include "AlarmStateList.h"
+#include "FlightObjectList.h"
+
+// Single-producer single-consumer ring buffer: the producer only writes the
+// head, the consumer only the tail. An entry is published by the release
+// store of the head and released by the release store of the tail.
+// Positions wrap around at 2^32.
+// The per slot levels are only changed if the event fits into the queue,
+// so a change is queued again after the next prediction.
+
+
+static int alarmEventQueuePush(TOcapContext *ctx, EAlarmEventType type, uint32_t ts,
+	TAlarmEventSlot *s, EAlarmLevel level, int timeToEncounterSec, int distMtr);
+
+static int alarmEventQueueClearSlot(TOcapContext *ctx, TAlarmEventSlot *s, uint32_t ts);
+
+
+int alarmEventQueuePop(TOcapContext *ctx, TAlarmEvent *event)
+{
+	if (!ctx->alarmEventQueue) {
+		return 0;
+	}
+	uint32_t tail = ctx->alarmEventQueueTail;
+	uint32_t head = __atomic_load_n(&ctx->alarmEventQueueHead, __ATOMIC_ACQUIRE);
+	if (tail == head) {
+		return 0;
+	}
+	*event = ctx->alarmEventQueue[tail & ctx->alarmEventQueueMask];
+	__atomic_store_n(&ctx->alarmEventQueueTail, tail + 1, __ATOMIC_RELEASE);
+	return 1;
+}
+
+uint32_t alarmEventQueueGetOverflowCount(TOcapContext *ctx)
+{
+	return __atomic_load_n(&ctx->alarmEventQueueOverflows, __ATOMIC_RELAXED);
+}
+
+void alarmEventQueueUpdate(TOcapContext *ctx, uint32_t ts)
+{
+	if (!ctx->alarmEventQueue) {
+		return;
+	}
+
+	// Raised, escalated and de-escalated alarms, the most critical first.
+	for (int i = 0, imax = alarmStateListGetCount(ctx); i < imax; i++) {
+		TAlarmState *a = alarmStateListGetAtIndex(ctx, i);
+		TFlightObjectOther *f = a->flightObject;
+		if (!f || a->level == ALARM_LEVEL_NONE) {
+			continue;
+		}
+		TAlarmEventSlot *s = &ctx->alarmEventSlots[f - ctx->flightObjects];
+		int isActive = s->level != ALARM_LEVEL_NONE;
+		if (isActive && s->flightObjectHandle != a->flightObjectHandle) {
+			// The slot has been reused by a new flight object.
+			alarmEventQueueClearSlot(ctx, s, ts);
+		}
+		if (s->level == ALARM_LEVEL_NONE || s->flightObjectHandle == a->flightObjectHandle) {
+			EAlarmEventType type = s->level == ALARM_LEVEL_NONE ? ALARM_EVENT_RAISED
+				: a->level > s->level ? ALARM_EVENT_ESCALATED
+				: a->level < s->level ? ALARM_EVENT_DEESCALATED
+				: (EAlarmEventType)0;
+			if (type) {
+				s->flightObjectHandle = a->flightObjectHandle;
+				s->id = f->id;
+				int distMtr = (int)vectorGetLength(&a->curDistanceToFlightObject);
+				if (alarmEventQueuePush(ctx, type, ts, s, a->level,
+						a->timeToEncounterSec, distMtr) == 0) {
+					s->level = (uint8_t)a->level;
+				}
+			}
+		}
+		if (s->level != ALARM_LEVEL_NONE) {
+			s->isSeen = 1;
+			if (!isActive) {
+				ctx->alarmEventActiveSlots[ctx->alarmEventActiveCount++] =
+					(uint16_t)(f - ctx->flightObjects);
+			}
+		}
+	}
+
+	// Cleared alarms: the slots without alarm state in this prediction.
+	for (int i = ctx->alarmEventActiveCount - 1; i >= 0; i--) {
+		TAlarmEventSlot *s = &ctx->alarmEventSlots[ctx->alarmEventActiveSlots[i]];
+		if (s->isSeen) {
+			s->isSeen = 0;
+			continue;
+		}
+		if (s->level != ALARM_LEVEL_NONE && alarmEventQueueClearSlot(ctx, s, ts) != 0) {
+			continue;
+		}
+		ctx->alarmEventActiveSlots[i] =
+			ctx->alarmEventActiveSlots[--ctx->alarmEventActiveCount];
+	}
+}
+
+void alarmEventQueueInit(TOcapContext *ctx)
+{
+	ctx->alarmEventQueueHead = 0;
+	ctx->alarmEventQueueTail = 0;
+	ctx->alarmEventQueueOverflows = 0;
+	ctx->alarmEventActiveCount = 0;
+	for (int i = 0; ctx->alarmEventSlots && i < ctx->flightObjectCapacity; i++) {
+		ctx->alarmEventSlots[i].level = ALARM_LEVEL_NONE;
+		ctx->alarmEventSlots[i].isSeen = 0;
+	}
+}
+
+// Returns 0 on success, -1 if the queue is full.
+static int alarmEventQueuePush(TOcapContext *ctx, EAlarmEventType type, uint32_t ts,
+	TAlarmEventSlot *s, EAlarmLevel level, int timeToEncounterSec, int distMtr)
+{
+	uint32_t head = ctx->alarmEventQueueHead;
+	uint32_t tail = __atomic_load_n(&ctx->alarmEventQueueTail, __ATOMIC_ACQUIRE);
+	if (head - tail > ctx->alarmEventQueueMask) {
+		__atomic_fetch_add(&ctx->alarmEventQueueOverflows, 1, __ATOMIC_RELAXED);
+		return -1;
+	}
+
+	TAlarmEvent *e = &ctx->alarmEventQueue[head & ctx->alarmEventQueueMask];
+	e->type = type;
+	e->ts = ts;
+	e->id = s->id;
+	e->flightObjectHandle = s->flightObjectHandle;
+	e->level = level;
+	e->previousLevel = (EAlarmLevel)s->level;
+	e->timeToEncounterSec = timeToEncounterSec;
+	e->distMtr = distMtr;
+	__atomic_store_n(&ctx->alarmEventQueueHead, head + 1, __ATOMIC_RELEASE);
+	return 0;
+}
+
+// Queues the cleared event of the flight object of slot s. Returns 0 on
+// success, -1 if the queue is full.
+static int alarmEventQueueClearSlot(TOcapContext *ctx, TAlarmEventSlot *s, uint32_t ts)
+{
+	// The flight object may have been released in the meantime.
+	int distMtr = -1;
+	TFlightObjectOther *f = flightObjectListGetOtherByHandle(ctx, s->flightObjectHandle);
+	if (f) {
+		TVector ownToOther;
+		vectorCopy(&ownToOther, &f->rxPos);
+		vectorSubtractVector(&ownToOther, &flightObjectListGetOwn(ctx)->rxPos);
+		distMtr = (int)vectorGetLength(&ownToOther);
+	}
+	if (alarmEventQueuePush(ctx, ALARM_EVENT_CLEARED, ts, s, ALARM_LEVEL_NONE, -1, distMtr) != 0) {
+		return -1;
+	}
+	s->level = ALARM_LEVEL_NONE;
+	return 0;
+}
@@ -0,0 +1,67 @@
+//
+// AlarmEventQueue.h
+//
+// OCAP - Open Collision Avoidance Protocol
+//
+// Queue of alarm events for an asynchronous consumer.
+//
+// 17.10.2026 ASR  First version.
+//
+// Software License (BSD):
+// Copyright 2026 Classy Code GmbH.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contribu-
+//    tors may be used to endorse or promote products derived from this soft-
+//    ware without specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS “AS IS”
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+
+#ifndef __ALARM_EVENT_QUEUE_H__
+#define __ALARM_EVENT_QUEUE_H__ 1
+
+#include <inttypes.h>
+#include "OcapContext.h"
+
+// The alarm state list must be read on the thread of the prediction,
+// between two predictions. Instead, another thread (e.g. the audio or
+// display task) can consume the changes of the alarms: after each
+// prediction, an event is queued for every flight object whose alarm
+// has been raised, escalated, de-escalated or cleared (TAlarmEvent,
+// declared in OcapContext.h). The most critical alarms come first.
+// The queue has a single producer (the prediction) and a single consumer;
+// neither of them blocks. It holds TOcapCapacities.alarmEventQueueLength
+// events; if it is full, the remaining changes are queued after the next
+// prediction (with the levels of that prediction), so the consumer doesn't
+// miss a cleared alarm.
+
+// Takes the oldest event out of the queue. Returns 1 on success, 0 if the
+// queue is empty. Must only be called by one thread at a time.
+int alarmEventQueuePop(TOcapContext *ctx, TAlarmEvent *event);
+
+// Number of times the queue was full when the prediction queued an event.
+uint32_t alarmEventQueueGetOverflowCount(TOcapContext *ctx);
+
+// Queues the events for the changes of the alarm state list since the last
+// call. Called at the end of the prediction.
+void alarmEventQueueUpdate(TOcapContext *ctx, uint32_t ts);
+
+// Called by ocapContextInitWithMemory.
+void alarmEventQueueInit(TOcapContext *ctx);
+
+#endif // __ALARM_EVENT_QUEUE_H__
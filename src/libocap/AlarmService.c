@@ -32,46 +32,57 @@
 
 #include "OcapLog.h"
 #include "AlarmService.h"
+#include "AlarmStateList.h"
+#include "FlightObjectList.h"
 
 #define FAR_AWAY_METERS 1000000
 
-// We stretch the alarm level (low=1, high=3) internally by this factor
-// so that we can apply a fine-grained decay.
-#define ALARM_SERVICE_FACTOR 4
-
-// For the moment, we maintain only 1 entry, for the most critical alarm.
-// A future extension would be to maintain multiple entries and provide
-// the most critical one to the client.
-static TAlarmServiceEntry sEntry;
+// If the table is full, a new entry replaces the one with the lowest level
+// that hasn't been updated in the current round. The levels of these
+// entries haven't changed since the end of the last round, which chains
+// the entries by level; so the lowest one is the first one of the lowest
+// chain, after dropping the entries that have been updated in the meantime.
 
 
 static void alarmServiceUpdateDataFields(
 	TAlarmServiceEntry *e, int targetLevel, int distMtr, int timeToEncounterSec);
 
+static TAlarmServiceEntry *alarmServiceGetOrAddEntry(
+	TOcapContext *ctx, TFlightObjectOther *f, TFlightObjectHandle handle, int targetLevel);
+static TAlarmServiceEntry *alarmServiceTakeLowestEntry(TOcapContext *ctx, int targetLevel);
+static void alarmServiceInitEntry(
+	TAlarmServiceEntry *e, TFlightObjectOther *f, TFlightObjectHandle handle);
+static void alarmServiceRemoveEntry(TOcapContext *ctx, int ix, int slot);
+
 
-void alarmServiceUpdateMostCritical(TAlarmState *a, int distMtr)
+void alarmServiceUpdateMostCritical(TOcapContext *ctx, TAlarmState *a, int distMtr)
 {
+	// This entry follows the most critical alarm only,
+	// see alarmServiceUpdate for the alarms of all aircraft.
+	TAlarmServiceEntry *e = &ctx->alarmServiceEntry;
+
 	// No alarm state: Decay slowly towards level 0.
 	if (!a) {
-		alarmServiceUpdateDataFields(&sEntry, 0, -1, -1);
+		alarmServiceUpdateDataFields(e, 0, -1, -1);
 		return;
 	}
 	// Convert alarm state levels (1 to 3) to our extended range.
 	int targetLevel = (int)a->level * ALARM_SERVICE_FACTOR;
 	int timeToEncounterSec = a->timeToEncounterSec;
-	if (a->flightObject && a->flightObject != sEntry.flightObject) {
+	if (a->flightObject && a->flightObjectHandle != e->flightObjectHandle) {
 		// A new aircraft causes the alarm.
 		// Remember the aircraft.
-		sEntry.flightObject = a->flightObject;
-		sEntry.distMtr = FAR_AWAY_METERS;
-		sEntry.approaching = 1;
+		e->flightObject = a->flightObject;
+		e->flightObjectHandle = a->flightObjectHandle;
+		e->distMtr = FAR_AWAY_METERS;
+		e->approaching = 1;
 	}
-	alarmServiceUpdateDataFields(&sEntry, targetLevel, distMtr, timeToEncounterSec);
+	alarmServiceUpdateDataFields(e, targetLevel, distMtr, timeToEncounterSec);
 }
 
-TAlarmServiceEntry *alarmServiceGetMostCritical(void)
+TAlarmServiceEntry *alarmServiceGetMostCritical(TOcapContext *ctx)
 {
-	return &sEntry;
+	return &ctx->alarmServiceEntry;
 }
 
 EAlarmLevel alarmServiceGetLevel(TAlarmServiceEntry *e)
@@ -87,6 +98,162 @@ EAlarmLevel alarmServiceGetLevel(TAlarmServiceEntry *e)
 	return (EAlarmLevel)((e->level + ALARM_SERVICE_FACTOR - 1) / ALARM_SERVICE_FACTOR);
 }
 
+void alarmServiceUpdate(TOcapContext *ctx)
+{
+	if (!ctx->alarmServiceCapacity) {
+		return;
+	}
+
+	// Boost or decay the entries of the aircraft with an alarm state,
+	// the most critical first in case the table is full.
+	for (int i = 0, imax = alarmStateListGetCount(ctx); i < imax; i++) {
+		TAlarmState *a = alarmStateListGetAtIndex(ctx, i);
+		if (!a->flightObject || a->level == ALARM_LEVEL_NONE) {
+			continue;
+		}
+		int targetLevel = (int)a->level * ALARM_SERVICE_FACTOR;
+		TAlarmServiceEntry *e = alarmServiceGetOrAddEntry(
+			ctx, a->flightObject, a->flightObjectHandle, targetLevel);
+		if (!e || e->isUpdated) {
+			continue;
+		}
+		int distMtr = (int)vectorGetLength(&a->curDistanceToFlightObject);
+		alarmServiceUpdateDataFields(e, targetLevel, distMtr, a->timeToEncounterSec);
+		e->isUpdated = 1;
+	}
+
+	// Decay the other entries towards level 0. Backwards, so that the
+	// entry moved into the place of a removed one has been visited. The
+	// remaining entries are chained by level for the next round.
+	for (int level = 0; level <= 3 * ALARM_SERVICE_FACTOR; level++) {
+		ctx->alarmServiceLevelFirst[level] = 0;
+	}
+	TFlightObjectOwn *fOwn = flightObjectListGetOwn(ctx);
+	for (int ix = ctx->alarmServiceCount - 1; ix >= 0; ix--) {
+		TAlarmServiceEntry *e = &ctx->alarmServiceEntries[ix];
+		int slot = (int)(e->flightObject - ctx->flightObjects);
+		if (e->isUpdated) {
+			e->isUpdated = 0;
+		} else {
+			// The aircraft may have been released in the meantime.
+			TFlightObjectOther *f = flightObjectListGetOtherByHandle(ctx, e->flightObjectHandle);
+			if (!f) {
+				alarmServiceRemoveEntry(ctx, ix, slot);
+				continue;
+			}
+			TVector ownToOther;
+			vectorCopy(&ownToOther, &f->rxPos);
+			vectorSubtractVector(&ownToOther, &fOwn->rxPos);
+			alarmServiceUpdateDataFields(e, 0, (int)vectorGetLength(&ownToOther), -1);
+			if (e->level <= 0) {
+				alarmServiceRemoveEntry(ctx, ix, slot);
+				continue;
+			}
+		}
+		e->nextOfLevel = ctx->alarmServiceLevelFirst[e->level];
+		ctx->alarmServiceLevelFirst[e->level] = (uint16_t)(slot + 1);
+	}
+}
+
+int alarmServiceGetCount(TOcapContext *ctx)
+{
+	return ctx->alarmServiceCount;
+}
+
+TAlarmServiceEntry *alarmServiceGetAtIndex(TOcapContext *ctx, int ix)
+{
+	return &ctx->alarmServiceEntries[ix];
+}
+
+TAlarmServiceEntry *alarmServiceGetByHandle(TOcapContext *ctx, TFlightObjectHandle handle)
+{
+	TFlightObjectOther *f = flightObjectListGetOtherByHandle(ctx, handle);
+	if (!f || !ctx->alarmServiceCapacity) {
+		return 0L;
+	}
+	int ix = (int)ctx->alarmServiceSlotEntry[f - ctx->flightObjects] - 1;
+	if (ix < 0 || ctx->alarmServiceEntries[ix].flightObjectHandle != handle) {
+		return 0L;
+	}
+	return &ctx->alarmServiceEntries[ix];
+}
+
+
+// Returns the entry of the aircraft in the table, a new one or 0 if the
+// table is full of entries with at least the target level.
+static TAlarmServiceEntry *alarmServiceGetOrAddEntry(
+	TOcapContext *ctx, TFlightObjectOther *f, TFlightObjectHandle handle, int targetLevel)
+{
+	int slot = (int)(f - ctx->flightObjects);
+	int ix = (int)ctx->alarmServiceSlotEntry[slot] - 1;
+	if (ix >= 0) {
+		TAlarmServiceEntry *e = &ctx->alarmServiceEntries[ix];
+		if (e->flightObjectHandle != handle) {
+			// The slot has been reused by a new aircraft.
+			alarmServiceInitEntry(e, f, handle);
+		}
+		return e;
+	}
+
+	if (ctx->alarmServiceCount < ctx->alarmServiceCapacity) {
+		ix = ctx->alarmServiceCount++;
+	} else {
+		// Replace the entry with the lowest level (not updated in this round).
+		TAlarmServiceEntry *eLowest = alarmServiceTakeLowestEntry(ctx, targetLevel);
+		if (!eLowest) {
+			return 0L;
+		}
+		ix = (int)(eLowest - ctx->alarmServiceEntries);
+		ctx->alarmServiceSlotEntry[eLowest->flightObject - ctx->flightObjects] = 0;
+	}
+	TAlarmServiceEntry *e = &ctx->alarmServiceEntries[ix];
+	alarmServiceInitEntry(e, f, handle);
+	ctx->alarmServiceSlotEntry[slot] = (uint16_t)(ix + 1);
+	return e;
+}
+
+// Takes the entry with the lowest level below the target level that hasn't
+// been updated in this round out of its chain. Returns 0 if there is none.
+static TAlarmServiceEntry *alarmServiceTakeLowestEntry(TOcapContext *ctx, int targetLevel)
+{
+	for (int level = 0; level < targetLevel; level++) {
+		uint16_t *first = &ctx->alarmServiceLevelFirst[level];
+		while (*first) {
+			int ix = (int)ctx->alarmServiceSlotEntry[*first - 1] - 1;
+			TAlarmServiceEntry *e = &ctx->alarmServiceEntries[ix];
+			*first = e->nextOfLevel;
+			if (!e->isUpdated) {
+				return e;
+			}
+		}
+	}
+	return 0L;
+}
+
+static void alarmServiceInitEntry(
+	TAlarmServiceEntry *e, TFlightObjectOther *f, TFlightObjectHandle handle)
+{
+	e->flightObject = f;
+	e->flightObjectHandle = handle;
+	e->level = 0;
+	e->distMtr = FAR_AWAY_METERS;
+	e->timeToEncounterSec = -1;
+	e->approaching = 1;
+	e->isUpdated = 0;
+}
+
+// Removes entry ix of the aircraft in the flight object slot by moving
+// the last entry into its place.
+static void alarmServiceRemoveEntry(TOcapContext *ctx, int ix, int slot)
+{
+	ctx->alarmServiceSlotEntry[slot] = 0;
+	int last = --ctx->alarmServiceCount;
+	if (ix != last) {
+		TAlarmServiceEntry *e = &ctx->alarmServiceEntries[ix];
+		*e = ctx->alarmServiceEntries[last];
+		ctx->alarmServiceSlotEntry[e->flightObject - ctx->flightObjects] = (uint16_t)(ix + 1);
+	}
+}
 
 static void alarmServiceUpdateDataFields(
 	TAlarmServiceEntry *e, int targetLevel, int distMtr, int timeToEncounterSec)
@@ -124,5 +291,6 @@ static void alarmServiceUpdateDataFields(
 	if (e->level <= 0) {
 		e->level = 0;
 		e->flightObject = 0L;
+		e->flightObjectHandle = 0;
 	}
 }
@@ -34,20 +34,31 @@
 #define __ALARM_SERVICE_H__ 1
 
 #include "AlarmState.h"
+#include "OcapContext.h"
 
-typedef struct {
-	TFlightObjectOther *flightObject;
-	int level;
-	int distMtr;
-	int timeToEncounterSec;
-	int approaching;
-} TAlarmServiceEntry;
+// TAlarmServiceEntry is declared in OcapContext.h.
 
 // If the distance is not available, pass -1 to this function.
-void alarmServiceUpdateMostCritical(TAlarmState *a, int distMtr);
+void alarmServiceUpdateMostCritical(TOcapContext *ctx, TAlarmState *a, int distMtr);
 
-TAlarmServiceEntry *alarmServiceGetMostCritical(void);
+TAlarmServiceEntry *alarmServiceGetMostCritical(TOcapContext *ctx);
 
 EAlarmLevel alarmServiceGetLevel(TAlarmServiceEntry *e);
 
+// Filters the alarms of all aircraft, e.g. for a display with several
+// aircraft: call this function after each prediction to update the
+// table of the context (capacity TOcapCapacities.alarmServiceEntries) with
+// the alarm states. Each aircraft keeps its entry as long as its level
+// hasn't decayed to 0 (independently of the most critical alarm above);
+// if the table is full, the entry with the lowest level is replaced.
+// The alarm states must refer to the flight objects of ctx.
+void alarmServiceUpdate(TOcapContext *ctx);
+
+// Entries of the table, in no particular order.
+int alarmServiceGetCount(TOcapContext *ctx);
+TAlarmServiceEntry *alarmServiceGetAtIndex(TOcapContext *ctx, int ix);
+
+// Returns the entry of the aircraft, or 0 if it has none.
+TAlarmServiceEntry *alarmServiceGetByHandle(TOcapContext *ctx, TFlightObjectHandle handle);
+
 #endif // __ALARM_SERVICE_H__
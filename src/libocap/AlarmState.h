@@ -47,6 +47,8 @@ typedef enum {
 
 typedef struct {
 	TFlightObjectOther *flightObject;
+	// Handle of flightObject, see flightObjectListGetOtherByHandle.
+	TFlightObjectHandle flightObjectHandle;
 	TVector curDistanceToFlightObject;
 	int timeToEncounterSec;
 	EAlarmLevel level;
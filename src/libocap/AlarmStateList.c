@@ -35,117 +35,242 @@
 #include "OcapLog.h"
 #include "AlarmStateList.h"
 
-// Calculating this value ad-hoc will save space but increase computing time on insert.
-#define ALARM_STATE_PRIO(l, t) (100 * (int)l + (T_MAX_SEC - t))
+// The list keeps the alarm states with the highest priority, at most the
+// capacity K of the context. A binary heap with the lowest priority at the
+// root finds the alarm state to replace in O(1) and reorders in O(log K);
+// a hash index from the flight object to its alarm state avoids a search.
+// Equal priorities are ordered by insertion (the first one is more
+// critical). The sorted order is only calculated when it's read.
 
 
-static TAlarmState sAlarmStates[ALARM_STATE_LIST_LENGTH];
-static int sAlarmStateOrder[ALARM_STATE_LIST_LENGTH];
-static int sAlarmStateSize;
+static int alarmStateListIsLess(TOcapContext *ctx, int a1, int a2);
+static void alarmStateListHeapSet(TOcapContext *ctx, int pos, int a);
+static void alarmStateListSiftUp(TOcapContext *ctx, int pos);
+static void alarmStateListSiftDown(TOcapContext *ctx, int *heap, int size, int pos);
+static void alarmStateListSort(TOcapContext *ctx);
 
+static int alarmStateListIndexHash(TOcapContext *ctx, TFlightObjectOther *f);
+static int alarmStateListIndexFind(TOcapContext *ctx, TFlightObjectOther *f);
+static void alarmStateListIndexRemove(TOcapContext *ctx, int pos);
 
-static void alarmStateListSort(void);
 
-
-void alarmStateListClear(void)
+void alarmStateListClear(TOcapContext *ctx)
 {
-	sAlarmStateSize = 0;
-	for (int i = 0; i < ALARM_STATE_LIST_LENGTH; i++) {
-		sAlarmStateOrder[i] = -1;
+	ctx->alarmStateSize = 0;
+	ctx->alarmStateNextSeq = 0;
+	ctx->alarmStateOrderIsValid = 1;
+	for (int i = 0; i <= ctx->alarmStateIndexMask; i++) {
+		ctx->alarmStateIndex[i] = 0;
 	}
 }
 
-int alarmStateListGetCount(void)
+int alarmStateListGetCount(TOcapContext *ctx)
 {
-	return sAlarmStateSize;
+	return ctx->alarmStateSize;
 }
 
-TAlarmState *alarmStateListGetAtIndex(int ix)
+TAlarmState *alarmStateListGetAtIndex(TOcapContext *ctx, int ix)
 {
-	int o = sAlarmStateOrder[ix];
-	TAlarmState *a = &sAlarmStates[o];
+	if (!ctx->alarmStateOrderIsValid) {
+		alarmStateListSort(ctx);
+	}
+	int o = ctx->alarmStateOrder[ix];
+	TAlarmState *a = &ctx->alarmStates[o];
 	return a;
 }
 
 TAlarmState *alarmStateListAdd(
-	TFlightObjectOther *f, EAlarmLevel l, int timeToEncounterSec)
+	TOcapContext *ctx, TFlightObjectOther *f, EAlarmLevel l, int timeToEncounterSec)
 {
 	int newPrio = ALARM_STATE_PRIO(l, timeToEncounterSec);
 
 	// Can we re-use an alarm state for this aircraft?
-	for (int i = 0; i < sAlarmStateSize; i++) {
-		TAlarmState *a = &sAlarmStates[i];
-		if (a->flightObject == f) {
-			if (newPrio > ALARM_STATE_PRIO(a->level, a->timeToEncounterSec)) {
-				a->level = l;
-				a->timeToEncounterSec = timeToEncounterSec;
-				ocapLogStrIntInt("ALARM-UPD", a->level, a->timeToEncounterSec);
-				alarmStateListSort();
-			}
-			return a;
+	int pos = alarmStateListIndexFind(ctx, f);
+	if (ctx->alarmStateIndex[pos]) {
+		int i = ctx->alarmStateIndex[pos] - 1;
+		TAlarmState *a = &ctx->alarmStates[i];
+		if (newPrio > ALARM_STATE_PRIO(a->level, a->timeToEncounterSec)) {
+			a->level = l;
+			a->timeToEncounterSec = timeToEncounterSec;
+			ocapLogStrIntInt("ALARM-UPD", a->level, a->timeToEncounterSec);
+			// Higher priority: towards the leaves.
+			alarmStateListSiftDown(ctx, ctx->alarmStateHeap, ctx->alarmStateSize,
+				ctx->alarmStateHeapPos[i]);
+			ctx->alarmStateOrderIsValid = 0;
 		}
+		return a;
 	}
 
-	TAlarmState *aNew = NULL;
-	if (sAlarmStateSize < ALARM_STATE_LIST_LENGTH) {
+	int i;
+	if (ctx->alarmStateSize < ctx->alarmStateCapacity) {
 		// The list has some remaining space. Take the next free element.
-		aNew = &sAlarmStates[sAlarmStateSize++];
+		i = ctx->alarmStateSize++;
+		alarmStateListHeapSet(ctx, ctx->alarmStateSize - 1, i);
 	} else {
-		// Select lowest prio entry via sAlarmStateOrder for replacement.
-		int o = sAlarmStateOrder[sAlarmStateSize - 1];
-		aNew = &sAlarmStates[o];
+		// Replace the lowest prio entry at the root of the heap.
+		i = ctx->alarmStateHeap[0];
+		TAlarmState *aLowest = &ctx->alarmStates[i];
 		// Don't insert the new alarm state if the list is full and has a lower prio than all existing items.
-		int aLowestPrio = ALARM_STATE_PRIO(aNew->level, aNew->timeToEncounterSec);
+		int aLowestPrio = ALARM_STATE_PRIO(aLowest->level, aLowest->timeToEncounterSec);
 		if (aLowestPrio > newPrio) {
 			return NULL;
 		}
+		alarmStateListIndexRemove(ctx, alarmStateListIndexFind(ctx, aLowest->flightObject));
+		// The index position may have moved.
+		pos = alarmStateListIndexFind(ctx, f);
 	}
 
+	TAlarmState *aNew = &ctx->alarmStates[i];
 	aNew->flightObject = f;
+	aNew->flightObjectHandle = f ? f->handle : 0;
 	aNew->level = l;
 	aNew->timeToEncounterSec = timeToEncounterSec;
+	ctx->alarmStateSeq[i] = ctx->alarmStateNextSeq++;
+	ctx->alarmStateIndex[pos] = i + 1;
 
-	alarmStateListSort();
+	if (ctx->alarmStateHeapPos[i] == ctx->alarmStateSize - 1) {
+		// Appended as a leaf.
+		alarmStateListSiftUp(ctx, ctx->alarmStateSize - 1);
+	} else {
+		// Replaced the root.
+		alarmStateListSiftDown(ctx, ctx->alarmStateHeap, ctx->alarmStateSize, 0);
+	}
+	ctx->alarmStateOrderIsValid = 0;
 	return aNew;
 }
 
-static void alarmStateListSort(void)
+// Returns 1 if alarm state a1 is less critical than a2.
+static int alarmStateListIsLess(TOcapContext *ctx, int a1, int a2)
+{
+	TAlarmState *s1 = &ctx->alarmStates[a1];
+	TAlarmState *s2 = &ctx->alarmStates[a2];
+	int prio1 = ALARM_STATE_PRIO(s1->level, s1->timeToEncounterSec);
+	int prio2 = ALARM_STATE_PRIO(s2->level, s2->timeToEncounterSec);
+	if (prio1 != prio2) {
+		return prio1 < prio2;
+	}
+	return ctx->alarmStateSeq[a1] > ctx->alarmStateSeq[a2];
+}
+
+static void alarmStateListHeapSet(TOcapContext *ctx, int pos, int a)
+{
+	ctx->alarmStateHeap[pos] = a;
+	ctx->alarmStateHeapPos[a] = pos;
+}
+
+static void alarmStateListSiftUp(TOcapContext *ctx, int pos)
+{
+	int a = ctx->alarmStateHeap[pos];
+	while (pos > 0) {
+		int parent = (pos - 1) / 2;
+		if (!alarmStateListIsLess(ctx, a, ctx->alarmStateHeap[parent])) {
+			break;
+		}
+		alarmStateListHeapSet(ctx, pos, ctx->alarmStateHeap[parent]);
+		pos = parent;
+	}
+	alarmStateListHeapSet(ctx, pos, a);
+}
+
+// Moves the entry at pos of heap (the list heap or the order array)
+// towards the leaves. Only updates the heap positions for the list heap.
+static void alarmStateListSiftDown(TOcapContext *ctx, int *heap, int size, int pos)
+{
+	int isListHeap = heap == ctx->alarmStateHeap;
+	int a = heap[pos];
+	for (;;) {
+		int child = 2 * pos + 1;
+		if (child >= size) {
+			break;
+		}
+		if (child + 1 < size && alarmStateListIsLess(ctx, heap[child + 1], heap[child])) {
+			child++;
+		}
+		if (!alarmStateListIsLess(ctx, heap[child], a)) {
+			break;
+		}
+		heap[pos] = heap[child];
+		if (isListHeap) {
+			ctx->alarmStateHeapPos[heap[pos]] = pos;
+		}
+		pos = child;
+	}
+	heap[pos] = a;
+	if (isListHeap) {
+		ctx->alarmStateHeapPos[a] = pos;
+	}
+}
+
+// Calculates the order by descending priority: heap sort of a copy of the
+// heap, which moves the least critical alarm state to the end first.
+static void alarmStateListSort(TOcapContext *ctx)
 {
-	// Selection sort.
-	// Start with unsorted array.
-	for (int i = 0; i < sAlarmStateSize; i++) {
-		sAlarmStateOrder[i] = i;
+	int *order = ctx->alarmStateOrder;
+	for (int i = 0; i < ctx->alarmStateSize; i++) {
+		order[i] = ctx->alarmStateHeap[i];
+	}
+	for (int end = ctx->alarmStateSize - 1; end > 0; end--) {
+		int tmp = order[0];
+		order[0] = order[end];
+		order[end] = tmp;
+		alarmStateListSiftDown(ctx, order, end, 0);
 	}
-	// Sort by moving the entry with the highest prio to the front.
-	for (int i = 0; i < sAlarmStateSize; i++) {
-		TAlarmState *aI = &sAlarmStates[sAlarmStateOrder[i]];
-		int prioI = ALARM_STATE_PRIO(aI->level, aI->timeToEncounterSec);
-
-		for (int j = i + 1; j < sAlarmStateSize; j++) {
-			TAlarmState *aJ = &sAlarmStates[sAlarmStateOrder[j]];
-			int prioJ = ALARM_STATE_PRIO(aJ->level, aJ->timeToEncounterSec);
-
-			if (prioI < prioJ) {
-				// Need to swap.
-				int tmp = sAlarmStateOrder[i];
-				sAlarmStateOrder[i] = sAlarmStateOrder[j];
-				sAlarmStateOrder[j] = tmp;
-				// One assignment is enough for the pointers as we don't need aJ any more.
-				aI = aJ;
-				prioI = prioJ;
-			}
+	ctx->alarmStateOrderIsValid = 1;
+}
+
+static int alarmStateListIndexHash(TOcapContext *ctx, TFlightObjectOther *f)
+{
+	// Fibonacci hashing of the handle (generation and list slot).
+	uint32_t handle = f ? f->handle : 0;
+	return (int)((handle * 2654435769u) >> 16) & ctx->alarmStateIndexMask;
+}
+
+// Returns the index position of the flight object, or the empty position
+// where it would be inserted.
+static int alarmStateListIndexFind(TOcapContext *ctx, TFlightObjectOther *f)
+{
+	int pos = alarmStateListIndexHash(ctx, f);
+	while (ctx->alarmStateIndex[pos]) {
+		if (ctx->alarmStates[ctx->alarmStateIndex[pos] - 1].flightObject == f) {
+			break;
+		}
+		pos = (pos + 1) & ctx->alarmStateIndexMask;
+	}
+	return pos;
+}
+
+// Clears the index entry at pos and moves the following entries
+// of the probe sequence back, so that we don't need tombstones.
+static void alarmStateListIndexRemove(TOcapContext *ctx, int pos)
+{
+	int hole = pos;
+	for (;;) {
+		pos = (pos + 1) & ctx->alarmStateIndexMask;
+		int entry = ctx->alarmStateIndex[pos];
+		if (!entry) {
+			break;
+		}
+		// Move the entry unless its home position lies cyclically
+		// in (hole, pos].
+		int home = alarmStateListIndexHash(ctx, ctx->alarmStates[entry - 1].flightObject);
+		int distHome = (pos - home) & ctx->alarmStateIndexMask;
+		int distHole = (pos - hole) & ctx->alarmStateIndexMask;
+		if (distHome >= distHole) {
+			ctx->alarmStateIndex[hole] = entry;
+			hole = pos;
 		}
 	}
+	ctx->alarmStateIndex[hole] = 0;
 }
 
 #if OCAP_SIMULATION == 1
 #include <stdio.h>
-void alarmStateListDump(void)
+void alarmStateListDump(TOcapContext *ctx)
 {
 	printf(" * ");
-	for (int i = 0, imax = alarmStateListGetCount(); i < imax; i++) {
-		int o = sAlarmStateOrder[i];
-		TAlarmState *a = alarmStateListGetAtIndex(i);
+	for (int i = 0, imax = alarmStateListGetCount(ctx); i < imax; i++) {
+		TAlarmState *a = alarmStateListGetAtIndex(ctx, i);
+		int o = ctx->alarmStateOrder[i];
 		printf(" -> [%d:%d,%d]", o, (int)a->level, a->timeToEncounterSec);
 	}
 	printf(" ->|\n");
@@ -38,18 +38,26 @@
 #include "AlarmState.h"
 #include "FlightObjectOther.h"
 #include "Configuration.h"
+#include "OcapContext.h"
 
-void alarmStateListClear(void);
+// Priority of an alarm state: the higher level first, then the earlier
+// encounter. Calculating this value ad-hoc will save space but increase
+// computing time on insert.
+#define ALARM_STATE_PRIO(l, t) (100 * (int)l + (T_MAX_SEC - t))
 
-int alarmStateListGetCount(void);
-TAlarmState *alarmStateListGetAtIndex(int ix);
+void alarmStateListClear(TOcapContext *ctx);
 
-// Returns the added alarm state.
+int alarmStateListGetCount(TOcapContext *ctx);
+TAlarmState *alarmStateListGetAtIndex(TOcapContext *ctx, int ix);
+
+// Returns the added (or updated) alarm state, or NULL if the list is full
+// of more critical alarm states. The pointer stays valid until the next
+// clear, but the alarm state may be replaced by one of another flight object.
 TAlarmState *alarmStateListAdd(
-  TFlightObjectOther *f, EAlarmLevel l, int timeToEncounterSec);
+  TOcapContext *ctx, TFlightObjectOther *f, EAlarmLevel l, int timeToEncounterSec);
 
 #if OCAP_SIMULATION == 1
-void alarmStateListDump(void);
+void alarmStateListDump(TOcapContext *ctx);
 #endif
 
 #endif // __ALARM_STATE_LIST_H__
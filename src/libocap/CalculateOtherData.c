@@ -37,16 +37,21 @@
 #include "OcapLog.h"
 #include "Configuration.h"
 #include "FlightPathExtrapolation.h"
+#include "FlightObjectList.h"
+#include "InputRecorder.h"
 
 
 // Call this method after receiving data on flight object f in our
 // neighbourhood. The center z is optional.
 void calculateOtherDataFromInfo(
+	TOcapContext *ctx,
 	TFlightObjectOther *f,
 	uint32_t ts,
 	TVector *curPos, TVector *curVel,  			// received
 	TVector *z, EOcapPathModel pathModel)   // received, optional
 {
+	inputRecorderRecordOther(ctx, f, ts, curPos, curVel, z, pathModel);
+
 	// Here we only store the information for future processing.
 
 	// If we have previously received a full data set, we ignore the new set.
@@ -60,6 +65,13 @@ void calculateOtherDataFromInfo(
 	f->timeSinceLastRxSec = 0;
 	vectorCopy(&f->rxPos, curPos);
 	vectorCopy(&f->rxVel, curVel);
+#if FLIGHT_OBJECT_OTHER_PATH_CACHE == 1
+	// The cached flight path is based on the old data.
+	f->pathCacheIsValid = 0;
+#endif
+#if FLIGHT_OBJECT_LIST_GRID == 1
+	flightObjectListUpdateOtherGrid(ctx, f);
+#endif
 
 	// We update the state of the object.
 	if (z) {
@@ -39,10 +39,12 @@
 #include "Vector.h"
 #include "FlightObjectOther.h"
 #include "FlightPathExtrapolation.h"
+#include "OcapContext.h"
 
 // Call this method after receiving data on flight object f in our
 // neighbourhood. The center z is optional.
 void calculateOtherDataFromInfo(
+	TOcapContext *ctx,
 	TFlightObjectOther *f,
 	uint32_t ts,
 	TVector *curPos, TVector *curVel, 	    // received
@@ -37,12 +37,15 @@
 #include "Configuration.h"
 #include "OcapLog.h"
 #include "FlightObjectList.h"
+#include "InputRecorder.h"
 
 
 // Call this method once per second.
-void calculateOwnDataFromGpsInfo(uint32_t ts, TVector *curPos, TVector *curVel)
+void calculateOwnDataFromGpsInfo(TOcapContext *ctx, uint32_t ts, TVector *curPos, TVector *curVel)
 {
-	TFlightObjectOwn *fOwn = flightObjectListGetOwn();
+	inputRecorderRecordOwn(ctx, ts, curPos, curVel);
+
+	TFlightObjectOwn *fOwn = flightObjectListGetOwn(ctx);
 
 	ocapLogFlVec(1, curPos, curVel);
 
@@ -52,3 +55,19 @@ void calculateOwnDataFromGpsInfo(uint32_t ts, TVector *curPos, TVector *curVel)
 	vectorCopy(&fOwn->rxVel, curVel);
 	fOwn->rxTs = ts;
 }
+
+void calculateOwnDataFromGlobalGpsInfo(TOcapContext *ctx, uint32_t ts, TLocalFrameGlobalPos *curPos, TVector *curVel)
+{
+	inputRecorderRecordOwnGlobal(ctx, ts, curPos, curVel);
+
+	TVector shift;
+	if (localFrameRebase(&ctx->localFrame, curPos, &shift)) {
+		flightObjectListShiftOrigin(ctx, &shift);
+	}
+
+	TVector localPos;
+	localFrameToLocal(&ctx->localFrame, curPos, &localPos);
+	ctx->inputRecorderSuspended++;
+	calculateOwnDataFromGpsInfo(ctx, ts, &localPos, curVel);
+	ctx->inputRecorderSuspended--;
+}
@@ -38,10 +38,21 @@
 
 #include <inttypes.h>
 #include "Vector.h"
+#include "OcapContext.h"
 
 // Call this method once per second.
 void calculateOwnDataFromGpsInfo(
+  TOcapContext *ctx,
   uint32_t ts,
   TVector *curPos, TVector *curVel);
 
+// Same as calculateOwnDataFromGpsInfo with curPos in global coordinates.
+// Moves the local frame (ctx->localFrame) with our own position and shifts
+// all stored positions accordingly. Convert the positions of the other
+// flight objects with localFrameToLocal.
+void calculateOwnDataFromGlobalGpsInfo(
+  TOcapContext *ctx,
+  uint32_t ts,
+  TLocalFrameGlobalPos *curPos, TVector *curVel);
+
 #endif // __CALCULATE_OWN_DATA_H__
@@ -0,0 +1,646 @@
+//
+// ConeCheck.c
+//
+// OCAP - Open Collision Avoidance Protocol
+//
+// Checking the predicted flight path of another aircraft against the
+// per-level truncated cones around our own predicted flight path.
+//
+// 17.10.2026 ASR  First version.
+//
+// Software License (BSD):
+// Copyright 2026 Classy Code GmbH.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contribu-
+//    tors may be used to endorse or promote products derived from this soft-
+//    ware without specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS “AS IS”
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+
+// All variants must round exactly like the scalar version. Therefore, this
+// file must be compiled without floating point contraction (fused
+// multiply-add), see -ffp-contract=off in the Makefile.
+
+#include <math.h>
+#include <inttypes.h>
+#include "ConeCheck.h"
+#include "FastMath.h"
+
+#if OCAP_FIXED_POINT == 1 || OCAP_FAST_MATH == 1
+// The fixed point and fast math versions are scalar.
+#elif CONE_CHECK_SIMD == 1 && defined(__AVX2__)
+#include <immintrin.h>
+#define CONE_CHECK_AVX2 1
+#elif CONE_CHECK_SIMD == 1 && defined(__SSE2__)
+#include <emmintrin.h>
+#define CONE_CHECK_SSE2 1
+#elif CONE_CHECK_SIMD == 1 && defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define CONE_CHECK_NEON 1
+#endif
+
+// Provide a lower bound (fixed safety zone) of 5m for each aircraft.
+// TODO MED make this configurable, or dependent on the aircraft?
+#define CONE_CHECK_V_MS_SQU_MIN 25.0f
+
+// Largest float below 2^31. The SIMD variants convert to int32, so larger
+// squared radii are clamped. As all distances checked are below
+// DIST_MTR_SQU_CHECK_LIMIT, this doesn't change the result.
+#define CONE_CHECK_SQU_MAX 2147483520.0f
+
+// Tolerance of the quadratic inequality in coneCheckCalculateLinear
+// for rounding errors of the predicted positions.
+#define CONE_CHECK_LINEAR_TOLERANCE_MTR 10.0
+#define CONE_CHECK_LINEAR_TOLERANCE_REL 0.01
+
+#if OCAP_FIXED_POINT == 1
+// Fraction bits of the fixed point cone check (positions and the
+// compensation are in FIXED_POS_SHIFT).
+#define CONE_CHECK_V_SQU_SHIFT 8
+#define CONE_CHECK_GROWTH_SHIFT 16
+#define CONE_CHECK_FAC_SHIFT 16
+// Distances are checked in 1/4m, so that the squares fit into uint32.
+#define CONE_CHECK_DIST_SHIFT 2
+#define CONE_CHECK_DIST_MAX 0xFFFF
+
+// sqrt(DIST_MTR_SQU_CHECK_LIMIT)
+#define CONE_CHECK_DIST_MTR_LIMIT 8000
+#if CONE_CHECK_DIST_MTR_LIMIT * CONE_CHECK_DIST_MTR_LIMIT != DIST_MTR_SQU_CHECK_LIMIT
+#error "CONE_CHECK_DIST_MTR_LIMIT doesn't match DIST_MTR_SQU_CHECK_LIMIT"
+#endif
+#endif
+
+
+static void coneCheckCalculateLevels(
+	TConeCheckOwn *own, TFlightPath *other, float vOtherMsSqu,
+	float compensationOther, float facLevel2, float facLevel1,
+	int32_t *levels);
+
+static EAlarmLevel coneCheckSelectLevel(int32_t *levels, int *timeToEncounterSec);
+
+#if OCAP_FIXED_POINT == 1
+static EAlarmLevel coneCheckCalculateLevelFixed(
+	TConeCheckOwn *own, int t, int32_t x, int32_t y, int32_t z, uint32_t vOtherMsSqu,
+	uint32_t compensationOther, uint32_t facLevel2, uint32_t facLevel1);
+
+static uint32_t coneCheckGetRadiusSquFixed(uint64_t dMin, uint32_t fac);
+#else
+static void coneCheckCalculateLevelsScalar(
+	TConeCheckOwn *own, TFlightPath *other, float vOtherMsSqu,
+	float compensationOther, float facLevel2, float facLevel1,
+	int32_t *levels);
+
+static EAlarmLevel coneCheckCalculateLevel(
+	TConeCheckOwn *own, int t, float x, float y, float z, float vOtherMsSqu,
+	float compensationOther, float facLevel2, float facLevel1);
+#endif
+
+#if PREDICTION_LINEAR_SOLVER == 1
+static int coneCheckFindFirst(double a, double b, double c, int tFrom);
+#endif
+
+
+void coneCheckSetOwn(TConeCheckOwn *own, float k, int t, TVector *pos, TVector *vel)
+{
+	flightPathExtrapolationSetPathPosition(&own->pos, t, pos);
+
+	float vMsSqu = vel->x * vel->x + vel->y * vel->y + vel->z * vel->z;
+	if (vMsSqu < CONE_CHECK_V_MS_SQU_MIN) {
+		vMsSqu = CONE_CHECK_V_MS_SQU_MIN;
+	}
+	own->vMsSqu[t] = vMsSqu;
+	own->growth[t] = 1.0f + 1.0f/k * t;
+	// Compensate input vector noise.
+	own->compensation[t] = 0.001f * ALARM_Z_OWN_COMPENSATION_MILLI_V * fastMathSqrt(vMsSqu);
+#if OCAP_FIXED_POINT == 1
+	own->vMsSquFixed[t] = (uint32_t)fixedFromFloat(vMsSqu, CONE_CHECK_V_SQU_SHIFT);
+	own->growthFixed[t] = (uint32_t)fixedFromFloat(own->growth[t], CONE_CHECK_GROWTH_SHIFT);
+	own->compensationFixed[t] = (uint32_t)fixedFromFloat(own->compensation[t], FIXED_POS_SHIFT);
+#endif
+
+	// The last sample also clears the padding, which the SIMD kernels load.
+	if (t == T_MAX_SEC - 1) {
+		flightPathExtrapolationClearPadding(&own->pos);
+		for (int i = T_MAX_SEC; i < FLIGHT_PATH_LENGTH; i++) {
+			own->vMsSqu[i] = 0;
+			own->growth[i] = 0;
+			own->compensation[i] = 0;
+#if OCAP_FIXED_POINT == 1
+			own->vMsSquFixed[i] = 0;
+			own->growthFixed[i] = 0;
+			own->compensationFixed[i] = 0;
+#endif
+		}
+	}
+}
+
+EAlarmLevel coneCheckCalculate(TConeCheckOwn *own, TFlightPath *other,
+	float vOtherMsSqu, float facLevel2, float facLevel1, int *timeToEncounterSec)
+{
+	if (vOtherMsSqu < CONE_CHECK_V_MS_SQU_MIN) {
+		vOtherMsSqu = CONE_CHECK_V_MS_SQU_MIN;
+	}
+	// Compensate Z vector resolution in ADS-L.
+	float compensationOther =
+		0.001f * ALARM_Z_OTHER_COMPENSATION_MILLI_V * fastMathSqrt(vOtherMsSqu);
+
+	int32_t levels[FLIGHT_PATH_LENGTH];
+	coneCheckCalculateLevels(own, other, vOtherMsSqu,
+		compensationOther, facLevel2, facLevel1, levels);
+	return coneCheckSelectLevel(levels, timeToEncounterSec);
+}
+
+#if OCAP_FIXED_POINT == 0
+EAlarmLevel coneCheckCalculateScalar(TConeCheckOwn *own, TFlightPath *other,
+	float vOtherMsSqu, float facLevel2, float facLevel1, int *timeToEncounterSec)
+{
+	if (vOtherMsSqu < CONE_CHECK_V_MS_SQU_MIN) {
+		vOtherMsSqu = CONE_CHECK_V_MS_SQU_MIN;
+	}
+	float compensationOther =
+		0.001f * ALARM_Z_OTHER_COMPENSATION_MILLI_V * fastMathSqrt(vOtherMsSqu);
+
+	int32_t levels[FLIGHT_PATH_LENGTH];
+	coneCheckCalculateLevelsScalar(own, other, vOtherMsSqu,
+		compensationOther, facLevel2, facLevel1, levels);
+	return coneCheckSelectLevel(levels, timeToEncounterSec);
+}
+#endif
+
+static EAlarmLevel coneCheckSelectLevel(int32_t *levels, int *timeToEncounterSec)
+{
+	// Highest level first, then the earliest encounter.
+	EAlarmLevel bestLevel = ALARM_LEVEL_NONE;
+	*timeToEncounterSec = 0;
+	for (int t = 0; t < T_MAX_SEC; t += T_DELTA_SEC) {
+		if (levels[t] > (int32_t)bestLevel) {
+			bestLevel = (EAlarmLevel)levels[t];
+			*timeToEncounterSec = t;
+		}
+	}
+	return bestLevel;
+}
+
+#if PREDICTION_LINEAR_SOLVER == 1
+EAlarmLevel coneCheckCalculateLinear(TConeCheckOwn *own, TVector *ownVel,
+	TFlightPathExtrapolationData *fpe, int32_t startSec,
+	float vOtherMsSqu, float facLevel2, float facLevel1, int *timeToEncounterSec)
+{
+	if (vOtherMsSqu < CONE_CHECK_V_MS_SQU_MIN) {
+		vOtherMsSqu = CONE_CHECK_V_MS_SQU_MIN;
+	}
+	// Compensate Z vector resolution in ADS-L.
+	float compensationOther =
+		0.001f * ALARM_Z_OTHER_COMPENSATION_MILLI_V * fastMathSqrt(vOtherMsSqu);
+
+	// Relative position _d_ at t = 0 and relative velocity _v_.
+	TVector otherPos;
+	TVector otherVel;
+	flightPathExtrapolationEvaluate(fpe, startSec + 1, &otherPos, &otherVel);
+	double dx = (double)otherPos.x - own->pos.x[0];
+	double dy = (double)otherPos.y - own->pos.y[0];
+	double dz = (double)otherPos.z - own->pos.z[0];
+	double vx = (double)otherVel.x - ownVel->x;
+	double vy = (double)otherVel.y - ownVel->y;
+	double vz = (double)otherVel.z - ownVel->z;
+
+	// Cone radius r(t) := r0 + r1 * t (our velocity is constant).
+	double s = sqrt((double)own->vMsSqu[0] + vOtherMsSqu);
+	double r0 = own->growth[0] * s + compensationOther + own->compensation[0];
+	double r1 = (own->growth[T_MAX_SEC - 1] - own->growth[0]) / (T_MAX_SEC - 1) * s;
+
+	*timeToEncounterSec = 0;
+	for (int l = ALARM_LEVEL_3; l >= ALARM_LEVEL_1; l--) {
+		double fac = 1.0;
+		if (l == ALARM_LEVEL_2) {
+			fac = facLevel2;
+		} else if (l == ALARM_LEVEL_1) {
+			fac = facLevel1;
+		}
+
+		// Enlarged radius p + q * t,
+		// |_d_ + t * _v_|^2 - (p + q * t)^2 <= 0  =>  a * t^2 + b * t + c <= 0
+		double p = r0 * fac * (1 + CONE_CHECK_LINEAR_TOLERANCE_REL) + CONE_CHECK_LINEAR_TOLERANCE_MTR;
+		double q = r1 * fac * (1 + CONE_CHECK_LINEAR_TOLERANCE_REL);
+		double a = vx * vx + vy * vy + vz * vz - q * q;
+		double b = 2 * (dx * vx + dy * vy + dz * vz - p * q);
+		double c = dx * dx + dy * dy + dz * dz - p * p;
+
+		// The exact check of the candidates decides, as in coneCheckCalculate.
+		for (int t = coneCheckFindFirst(a, b, c, 0); t < T_MAX_SEC;
+				t = coneCheckFindFirst(a, b, c, t + 1)) {
+			flightPathExtrapolationEvaluate(fpe, startSec + 1 + t, &otherPos, &otherVel);
+			EAlarmLevel level = coneCheckCalculateLevel(own, t,
+				otherPos.x, otherPos.y, otherPos.z, vOtherMsSqu,
+				compensationOther, facLevel2, facLevel1);
+			if (level >= l) {
+				*timeToEncounterSec = t;
+				return level;
+			}
+		}
+	}
+	return ALARM_LEVEL_NONE;
+}
+
+// Returns the first integer t >= tFrom with a * t^2 + b * t + c <= 0,
+// or T_MAX_SEC if there is none below T_MAX_SEC.
+static int coneCheckFindFirst(double a, double b, double c, int tFrom)
+{
+	if (tFrom >= T_MAX_SEC) {
+		return T_MAX_SEC;
+	}
+	double t0 = tFrom;
+	if ((a * t0 + b) * t0 + c <= 0) {
+		return tFrom;
+	}
+
+	double tFirst;
+	if (a == 0) {
+		// b * t + c <= 0
+		if (b >= 0) {
+			return T_MAX_SEC;
+		}
+		tFirst = -c / b;
+
+	} else {
+		double disc = b * b - 4 * a * c;
+		if (disc < 0) {
+			// Always positive (or negative, but then only rounding
+			// prevented the early return above).
+			return a > 0 ? T_MAX_SEC : tFrom;
+		}
+		// Numerically stable roots.
+		double h = -0.5 * (b + (b < 0 ? -sqrt(disc) : sqrt(disc)));
+		double t1 = h / a;
+		double t2 = (h != 0) ? c / h : t1;
+		double tLow = t1 < t2 ? t1 : t2;
+		double tHigh = t1 < t2 ? t2 : t1;
+
+		if (a > 0) {
+			// Between the roots.
+			if (t0 > tHigh) {
+				return T_MAX_SEC;
+			}
+			tFirst = tLow;
+		} else {
+			// Outside of the roots.
+			tFirst = tHigh;
+		}
+	}
+
+	if (tFirst <= t0) {
+		return tFrom;
+	}
+	if (tFirst >= T_MAX_SEC) {
+		return T_MAX_SEC;
+	}
+	return (int)ceil(tFirst);
+}
+#endif
+
+float coneCheckGetMaxRadius(TConeCheckOwn *own,
+	float vOtherMsSqu, float facLevel2, float facLevel1)
+{
+	if (vOtherMsSqu < CONE_CHECK_V_MS_SQU_MIN) {
+		vOtherMsSqu = CONE_CHECK_V_MS_SQU_MIN;
+	}
+
+	float vOwnMsSquMax = 0;
+	float growthMax = 0;
+	float compensationMax = 0;
+	for (int t = 0; t < T_MAX_SEC; t += T_DELTA_SEC) {
+		if (own->vMsSqu[t] > vOwnMsSquMax) {
+			vOwnMsSquMax = own->vMsSqu[t];
+		}
+		if (own->growth[t] > growthMax) {
+			growthMax = own->growth[t];
+		}
+		if (own->compensation[t] > compensationMax) {
+			compensationMax = own->compensation[t];
+		}
+	}
+
+	float dMinL3 = growthMax * fastMathSqrt(vOwnMsSquMax + vOtherMsSqu);
+	dMinL3 += 0.001f * ALARM_Z_OTHER_COMPENSATION_MILLI_V * fastMathSqrt(vOtherMsSqu);
+	dMinL3 += compensationMax;
+
+	float facMax = 1.0f;
+	if (facLevel2 > facMax) {
+		facMax = facLevel2;
+	}
+	if (facLevel1 > facMax) {
+		facMax = facLevel1;
+	}
+	return dMinL3 * facMax;
+}
+
+#if OCAP_FIXED_POINT == 1
+
+static void coneCheckCalculateLevels(
+	TConeCheckOwn *own, TFlightPath *other, float vOtherMsSqu,
+	float compensationOther, float facLevel2, float facLevel1,
+	int32_t *levels)
+{
+	// The only float operations per flight object.
+	uint32_t vOther = (uint32_t)fixedFromFloat(vOtherMsSqu, CONE_CHECK_V_SQU_SHIFT);
+	uint32_t compOther = (uint32_t)fixedFromFloat(compensationOther, FIXED_POS_SHIFT);
+	uint32_t fac2 = (uint32_t)fixedFromFloat(facLevel2, CONE_CHECK_FAC_SHIFT);
+	uint32_t fac1 = (uint32_t)fixedFromFloat(facLevel1, CONE_CHECK_FAC_SHIFT);
+
+	for (int t = 0; t < T_MAX_SEC; t += T_DELTA_SEC) {
+		levels[t] = coneCheckCalculateLevelFixed(own, t,
+			other->x[t], other->y[t], other->z[t], vOther,
+			compOther, fac2, fac1);
+	}
+}
+
+static EAlarmLevel coneCheckCalculateLevelFixed(
+	TConeCheckOwn *own, int t, int32_t x, int32_t y, int32_t z, uint32_t vOtherMsSqu,
+	uint32_t compensationOther, uint32_t facLevel2, uint32_t facLevel1)
+{
+	// Distance in 1/4m (saturated positions can be 2^32 apart).
+	const int shift = FIXED_POS_SHIFT - CONE_CHECK_DIST_SHIFT;
+	const int64_t half = (int64_t)1 << (shift - 1);
+	int64_t dx = ((int64_t)x - own->pos.x[t] + half) >> shift;
+	int64_t dy = ((int64_t)y - own->pos.y[t] + half) >> shift;
+	int64_t dz = ((int64_t)z - own->pos.z[t] + half) >> shift;
+
+	// Only check if within the limit, first for each axis.
+	const int64_t limit = (int64_t)CONE_CHECK_DIST_MTR_LIMIT << CONE_CHECK_DIST_SHIFT;
+	if (dx > limit || dx < -limit || dy > limit || dy < -limit
+			|| dz > limit || dz < -limit) {
+		return ALARM_LEVEL_NONE;
+	}
+	uint32_t distSqu = (uint32_t)(dx*dx) + (uint32_t)(dy*dy) + (uint32_t)(dz*dz);
+	if (distSqu > (uint32_t)DIST_MTR_SQU_CHECK_LIMIT << (2 * CONE_CHECK_DIST_SHIFT)) {
+		return ALARM_LEVEL_NONE;
+	}
+
+	// Cone radius for level 3 in 1/16m, as in coneCheckCalculateLevel.
+	uint32_t v = fixedSqrt(own->vMsSquFixed[t] + vOtherMsSqu);
+	uint64_t dMinL3 = ((uint64_t)own->growthFixed[t] * v) >> CONE_CHECK_GROWTH_SHIFT;
+	dMinL3 += compensationOther;
+	dMinL3 += own->compensationFixed[t];
+
+	if (distSqu <= coneCheckGetRadiusSquFixed(dMinL3, 1 << CONE_CHECK_FAC_SHIFT)) {
+		return ALARM_LEVEL_3;
+
+	} else if (distSqu <= coneCheckGetRadiusSquFixed(dMinL3, facLevel2)) {
+		return ALARM_LEVEL_2;
+
+	} else if (distSqu <= coneCheckGetRadiusSquFixed(dMinL3, facLevel1)) {
+		return ALARM_LEVEL_1;
+	}
+	return ALARM_LEVEL_NONE;
+}
+
+// Returns (dMin * fac)^2 in 1/16 m2 for dMin in 1/16m, clamped above the
+// limit of the cone check.
+static uint32_t coneCheckGetRadiusSquFixed(uint64_t dMin, uint32_t fac)
+{
+	const int shift = CONE_CHECK_FAC_SHIFT + FIXED_POS_SHIFT - CONE_CHECK_DIST_SHIFT;
+	if (dMin > (uint64_t)INT32_MAX) {
+		dMin = INT32_MAX;
+	}
+	uint64_t r = (dMin * fac + ((uint64_t)1 << (shift - 1))) >> shift;
+	if (r > CONE_CHECK_DIST_MAX) {
+		r = CONE_CHECK_DIST_MAX;
+	}
+	return (uint32_t)(r * r);
+}
+
+#elif CONE_CHECK_AVX2 == 1
+
+static void coneCheckCalculateLevels(
+	TConeCheckOwn *own, TFlightPath *other, float vOtherMsSqu,
+	float compensationOther, float facLevel2, float facLevel1,
+	int32_t *levels)
+{
+	const __m256 limit = _mm256_set1_ps((float)DIST_MTR_SQU_CHECK_LIMIT);
+	const __m256 squMax = _mm256_set1_ps(CONE_CHECK_SQU_MAX);
+	const __m256 vOther = _mm256_set1_ps(vOtherMsSqu);
+	const __m256 compOther = _mm256_set1_ps(compensationOther);
+	const __m256 fac2 = _mm256_set1_ps(facLevel2);
+	const __m256 fac1 = _mm256_set1_ps(facLevel1);
+
+	for (int t = 0; t < T_MAX_SEC; t += 8) {
+		__m256 dx = _mm256_sub_ps(_mm256_loadu_ps(&other->x[t]), _mm256_loadu_ps(&own->pos.x[t]));
+		__m256 dy = _mm256_sub_ps(_mm256_loadu_ps(&other->y[t]), _mm256_loadu_ps(&own->pos.y[t]));
+		__m256 dz = _mm256_sub_ps(_mm256_loadu_ps(&other->z[t]), _mm256_loadu_ps(&own->pos.z[t]));
+		__m256 distMtrSqu = _mm256_add_ps(
+			_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)),
+			_mm256_mul_ps(dz, dz));
+		__m256i inLimit = _mm256_castps_si256(_mm256_cmp_ps(distMtrSqu, limit, _CMP_LE_OQ));
+		__m256i distMtrSquInt = _mm256_cvttps_epi32(distMtrSqu);
+
+		__m256 dMinL3 = _mm256_mul_ps(_mm256_loadu_ps(&own->growth[t]),
+			_mm256_sqrt_ps(_mm256_add_ps(_mm256_loadu_ps(&own->vMsSqu[t]), vOther)));
+		dMinL3 = _mm256_add_ps(dMinL3, compOther);
+		dMinL3 = _mm256_add_ps(dMinL3, _mm256_loadu_ps(&own->compensation[t]));
+		__m256 dMinL3Squ = _mm256_mul_ps(dMinL3, dMinL3);
+		__m256 dMinL2Squ = _mm256_mul_ps(_mm256_mul_ps(dMinL3Squ, fac2), fac2);
+		__m256 dMinL1Squ = _mm256_mul_ps(_mm256_mul_ps(dMinL3Squ, fac1), fac1);
+		__m256i dMinL3SquInt = _mm256_cvttps_epi32(_mm256_min_ps(dMinL3Squ, squMax));
+		__m256i dMinL2SquInt = _mm256_cvttps_epi32(_mm256_min_ps(dMinL2Squ, squMax));
+		__m256i dMinL1SquInt = _mm256_cvttps_epi32(_mm256_min_ps(dMinL1Squ, squMax));
+
+		// Higher levels override lower ones, like the if-chain in the scalar version.
+		__m256i level = _mm256_setzero_si256();
+		level = _mm256_blendv_epi8(_mm256_set1_epi32(ALARM_LEVEL_1), level,
+			_mm256_cmpgt_epi32(distMtrSquInt, dMinL1SquInt));
+		level = _mm256_blendv_epi8(_mm256_set1_epi32(ALARM_LEVEL_2), level,
+			_mm256_cmpgt_epi32(distMtrSquInt, dMinL2SquInt));
+		level = _mm256_blendv_epi8(_mm256_set1_epi32(ALARM_LEVEL_3), level,
+			_mm256_cmpgt_epi32(distMtrSquInt, dMinL3SquInt));
+		level = _mm256_and_si256(level, inLimit);
+
+		_mm256_storeu_si256((__m256i *)&levels[t], level);
+	}
+}
+
+#elif CONE_CHECK_SSE2 == 1
+
+// Selects a where mask is set, b otherwise.
+static inline __m128i coneCheckSelect(__m128i mask, __m128i a, __m128i b)
+{
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static void coneCheckCalculateLevels(
+	TConeCheckOwn *own, TFlightPath *other, float vOtherMsSqu,
+	float compensationOther, float facLevel2, float facLevel1,
+	int32_t *levels)
+{
+	const __m128 limit = _mm_set1_ps((float)DIST_MTR_SQU_CHECK_LIMIT);
+	const __m128 squMax = _mm_set1_ps(CONE_CHECK_SQU_MAX);
+	const __m128 vOther = _mm_set1_ps(vOtherMsSqu);
+	const __m128 compOther = _mm_set1_ps(compensationOther);
+	const __m128 fac2 = _mm_set1_ps(facLevel2);
+	const __m128 fac1 = _mm_set1_ps(facLevel1);
+
+	for (int t = 0; t < T_MAX_SEC; t += 4) {
+		__m128 dx = _mm_sub_ps(_mm_loadu_ps(&other->x[t]), _mm_loadu_ps(&own->pos.x[t]));
+		__m128 dy = _mm_sub_ps(_mm_loadu_ps(&other->y[t]), _mm_loadu_ps(&own->pos.y[t]));
+		__m128 dz = _mm_sub_ps(_mm_loadu_ps(&other->z[t]), _mm_loadu_ps(&own->pos.z[t]));
+		__m128 distMtrSqu = _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)),
+			_mm_mul_ps(dz, dz));
+		__m128i inLimit = _mm_castps_si128(_mm_cmple_ps(distMtrSqu, limit));
+		__m128i distMtrSquInt = _mm_cvttps_epi32(distMtrSqu);
+
+		__m128 dMinL3 = _mm_mul_ps(_mm_loadu_ps(&own->growth[t]),
+			_mm_sqrt_ps(_mm_add_ps(_mm_loadu_ps(&own->vMsSqu[t]), vOther)));
+		dMinL3 = _mm_add_ps(dMinL3, compOther);
+		dMinL3 = _mm_add_ps(dMinL3, _mm_loadu_ps(&own->compensation[t]));
+		__m128 dMinL3Squ = _mm_mul_ps(dMinL3, dMinL3);
+		__m128 dMinL2Squ = _mm_mul_ps(_mm_mul_ps(dMinL3Squ, fac2), fac2);
+		__m128 dMinL1Squ = _mm_mul_ps(_mm_mul_ps(dMinL3Squ, fac1), fac1);
+		__m128i dMinL3SquInt = _mm_cvttps_epi32(_mm_min_ps(dMinL3Squ, squMax));
+		__m128i dMinL2SquInt = _mm_cvttps_epi32(_mm_min_ps(dMinL2Squ, squMax));
+		__m128i dMinL1SquInt = _mm_cvttps_epi32(_mm_min_ps(dMinL1Squ, squMax));
+
+		// Higher levels override lower ones, like the if-chain in the scalar version.
+		__m128i level = _mm_setzero_si128();
+		level = coneCheckSelect(_mm_cmpgt_epi32(distMtrSquInt, dMinL1SquInt),
+			level, _mm_set1_epi32(ALARM_LEVEL_1));
+		level = coneCheckSelect(_mm_cmpgt_epi32(distMtrSquInt, dMinL2SquInt),
+			level, _mm_set1_epi32(ALARM_LEVEL_2));
+		level = coneCheckSelect(_mm_cmpgt_epi32(distMtrSquInt, dMinL3SquInt),
+			level, _mm_set1_epi32(ALARM_LEVEL_3));
+		level = _mm_and_si128(level, inLimit);
+
+		_mm_storeu_si128((__m128i *)&levels[t], level);
+	}
+}
+
+#elif CONE_CHECK_NEON == 1
+
+static void coneCheckCalculateLevels(
+	TConeCheckOwn *own, TFlightPath *other, float vOtherMsSqu,
+	float compensationOther, float facLevel2, float facLevel1,
+	int32_t *levels)
+{
+	const float32x4_t limit = vdupq_n_f32((float)DIST_MTR_SQU_CHECK_LIMIT);
+	const float32x4_t squMax = vdupq_n_f32(CONE_CHECK_SQU_MAX);
+	const float32x4_t vOther = vdupq_n_f32(vOtherMsSqu);
+	const float32x4_t compOther = vdupq_n_f32(compensationOther);
+	const float32x4_t fac2 = vdupq_n_f32(facLevel2);
+	const float32x4_t fac1 = vdupq_n_f32(facLevel1);
+
+	for (int t = 0; t < T_MAX_SEC; t += 4) {
+		float32x4_t dx = vsubq_f32(vld1q_f32(&other->x[t]), vld1q_f32(&own->pos.x[t]));
+		float32x4_t dy = vsubq_f32(vld1q_f32(&other->y[t]), vld1q_f32(&own->pos.y[t]));
+		float32x4_t dz = vsubq_f32(vld1q_f32(&other->z[t]), vld1q_f32(&own->pos.z[t]));
+		float32x4_t distMtrSqu = vaddq_f32(
+			vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy)),
+			vmulq_f32(dz, dz));
+		uint32x4_t inLimit = vcleq_f32(distMtrSqu, limit);
+		int32x4_t distMtrSquInt = vcvtq_s32_f32(distMtrSqu);
+
+		float32x4_t dMinL3 = vmulq_f32(vld1q_f32(&own->growth[t]),
+			vsqrtq_f32(vaddq_f32(vld1q_f32(&own->vMsSqu[t]), vOther)));
+		dMinL3 = vaddq_f32(dMinL3, compOther);
+		dMinL3 = vaddq_f32(dMinL3, vld1q_f32(&own->compensation[t]));
+		float32x4_t dMinL3Squ = vmulq_f32(dMinL3, dMinL3);
+		float32x4_t dMinL2Squ = vmulq_f32(vmulq_f32(dMinL3Squ, fac2), fac2);
+		float32x4_t dMinL1Squ = vmulq_f32(vmulq_f32(dMinL3Squ, fac1), fac1);
+		int32x4_t dMinL3SquInt = vcvtq_s32_f32(vminq_f32(dMinL3Squ, squMax));
+		int32x4_t dMinL2SquInt = vcvtq_s32_f32(vminq_f32(dMinL2Squ, squMax));
+		int32x4_t dMinL1SquInt = vcvtq_s32_f32(vminq_f32(dMinL1Squ, squMax));
+
+		// Higher levels override lower ones, like the if-chain in the scalar version.
+		int32x4_t level = vdupq_n_s32(ALARM_LEVEL_NONE);
+		level = vbslq_s32(vcleq_s32(distMtrSquInt, dMinL1SquInt),
+			vdupq_n_s32(ALARM_LEVEL_1), level);
+		level = vbslq_s32(vcleq_s32(distMtrSquInt, dMinL2SquInt),
+			vdupq_n_s32(ALARM_LEVEL_2), level);
+		level = vbslq_s32(vcleq_s32(distMtrSquInt, dMinL3SquInt),
+			vdupq_n_s32(ALARM_LEVEL_3), level);
+		level = vandq_s32(level, vreinterpretq_s32_u32(inLimit));
+
+		vst1q_s32(&levels[t], level);
+	}
+}
+
+#else
+
+static void coneCheckCalculateLevels(
+	TConeCheckOwn *own, TFlightPath *other, float vOtherMsSqu,
+	float compensationOther, float facLevel2, float facLevel1,
+	int32_t *levels)
+{
+	coneCheckCalculateLevelsScalar(own, other, vOtherMsSqu,
+		compensationOther, facLevel2, facLevel1, levels);
+}
+
+#endif
+
+#if OCAP_FIXED_POINT == 0
+// Also the reference of the SIMD variants, see coneCheckCalculateScalar.
+static void coneCheckCalculateLevelsScalar(
+	TConeCheckOwn *own, TFlightPath *other, float vOtherMsSqu,
+	float compensationOther, float facLevel2, float facLevel1,
+	int32_t *levels)
+{
+	for (int t = 0; t < T_MAX_SEC; t += T_DELTA_SEC) {
+		levels[t] = coneCheckCalculateLevel(own, t,
+			other->x[t], other->y[t], other->z[t], vOtherMsSqu,
+			compensationOther, facLevel2, facLevel1);
+	}
+}
+
+static EAlarmLevel coneCheckCalculateLevel(
+	TConeCheckOwn *own, int t, float x, float y, float z, float vOtherMsSqu,
+	float compensationOther, float facLevel2, float facLevel1)
+{
+	float dx = x - own->pos.x[t];
+	float dy = y - own->pos.y[t];
+	float dz = z - own->pos.z[t];
+
+	// To save performance and avoid sqrt, we work with the squared distance.
+	float distMtrSqu = dx*dx + dy*dy + dz*dz;
+
+	// Only check if within the limit.
+	if (distMtrSqu > DIST_MTR_SQU_CHECK_LIMIT) {
+		return ALARM_LEVEL_NONE;
+	}
+
+	uint32_t distMtrSquInt = (uint32_t)distMtrSqu;
+
+	// Check if the predicted position of the other flight object
+	// is in one of our 3 per-level truncated cones.
+	float dMinL3 = own->growth[t] * fastMathSqrt(own->vMsSqu[t] + vOtherMsSqu);
+	dMinL3 += compensationOther;
+	dMinL3 += own->compensation[t];
+	uint32_t dMinL3SquInt = (uint32_t)(dMinL3 * dMinL3);
+	uint32_t dMinL2SquInt = (uint32_t)(dMinL3 * dMinL3 * facLevel2 * facLevel2);
+	uint32_t dMinL1SquInt = (uint32_t)(dMinL3 * dMinL3 * facLevel1 * facLevel1);
+
+	if (distMtrSquInt <= dMinL3SquInt) {
+		return ALARM_LEVEL_3;
+
+	} else if (distMtrSquInt <= dMinL2SquInt) {
+		return ALARM_LEVEL_2;
+
+	} else if (distMtrSquInt <= dMinL1SquInt) {
+		return ALARM_LEVEL_1;
+	}
+	return ALARM_LEVEL_NONE;
+}
+#endif
@@ -0,0 +1,98 @@
+//
+// ConeCheck.h
+//
+// OCAP - Open Collision Avoidance Protocol
+//
+// Checking the predicted flight path of another aircraft against the
+// per-level truncated cones around our own predicted flight path.
+//
+// 17.10.2026 ASR  First version.
+//
+// Software License (BSD):
+// Copyright 2026 Classy Code GmbH.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contribu-
+//    tors may be used to endorse or promote products derived from this soft-
+//    ware without specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS “AS IS”
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+
+#ifndef __CONE_CHECK_H__
+#define __CONE_CHECK_H__ 1
+
+#include "Configuration.h"
+#include "AlarmState.h"
+#include "FlightPathExtrapolation.h"
+
+// Our own predicted flight path and the per-sample parts of the cone
+// radii that don't depend on the other aircraft. As in TFlightPath, the
+// samples from T_MAX_SEC on are padding kept at 0.
+typedef struct {
+	TFlightPath pos;
+	// Squared velocity (m2/s2), at least the fixed safety zone.
+	float vMsSqu[FLIGHT_PATH_LENGTH];
+	// Cone growth factor 1 + t/k.
+	float growth[FLIGHT_PATH_LENGTH];
+	// Compensation of the input vector noise.
+	float compensation[FLIGHT_PATH_LENGTH];
+#if OCAP_FIXED_POINT == 1
+	// The same in fixed point: m2/s2 in Q8, growth in Q16, m in Q4.
+	uint32_t vMsSquFixed[FLIGHT_PATH_LENGTH];
+	uint32_t growthFixed[FLIGHT_PATH_LENGTH];
+	uint32_t compensationFixed[FLIGHT_PATH_LENGTH];
+#endif
+} TConeCheckOwn;
+
+// Stores the position and velocity of our own aircraft at t.
+// k is the cone growth parameter, see predictionInit.
+// The last sample (t = T_MAX_SEC-1) also clears the padding.
+void coneCheckSetOwn(TConeCheckOwn *own, float k, int t, TVector *pos, TVector *vel);
+
+// Checks the other aircraft's path for t = 0 ... T_MAX_SEC-1.
+// Returns the highest alarm level (or ALARM_LEVEL_NONE) and stores the
+// earliest t with that level in timeToEncounterSec.
+// The result is the same for all SIMD variants and the scalar version.
+// In fixed point, the per-sample checks don't use float.
+EAlarmLevel coneCheckCalculate(TConeCheckOwn *own, TFlightPath *other,
+	float vOtherMsSqu, float facLevel2, float facLevel1, int *timeToEncounterSec);
+
+#if OCAP_FIXED_POINT == 0
+// coneCheckCalculate with the scalar version, whatever CONE_CHECK_SIMD
+// selects: the reference of the SIMD variants in libocap-test.
+EAlarmLevel coneCheckCalculateScalar(TConeCheckOwn *own, TFlightPath *other,
+	float vOtherMsSqu, float facLevel2, float facLevel1, int *timeToEncounterSec);
+#endif
+
+#if PREDICTION_LINEAR_SOLVER == 1
+// Same result as coneCheckCalculate for the path predicted by
+// flightPathExtrapolationEvaluate(fpe, startSec+1+t) if both flight paths
+// are linear, ownVel being the velocity of our own aircraft.
+// The cone condition is a quadratic inequality in t in this case, only
+// the samples that can fulfill it are checked.
+EAlarmLevel coneCheckCalculateLinear(TConeCheckOwn *own, TVector *ownVel,
+	TFlightPathExtrapolationData *fpe, int32_t startSec,
+	float vOtherMsSqu, float facLevel2, float facLevel1, int *timeToEncounterSec);
+#endif
+
+// Returns an upper bound of the largest cone radius (any level, any t)
+// for an aircraft with the given velocity.
+float coneCheckGetMaxRadius(TConeCheckOwn *own,
+	float vOtherMsSqu, float facLevel2, float facLevel1);
+
+#endif // __CONE_CHECK_H__
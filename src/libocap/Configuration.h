@@ -38,13 +38,100 @@
 // Simulation, testing?
 #define OCAP_SIMULATION 1
 
-
-// Maximum number of flight objects that we can track (including our own).
+// Evaluate the predicted flight paths and check the cones in fixed point
+// arithmetic (1) instead of float (0), for microcontrollers without floating
+// point unit. The preparation of the extrapolation (once per flight object
+// and second) is still done in float.
+// The error bounds against float are documented in FixedPoint.h; alarms
+// can differ if the other aircraft is within about 1m of a cone boundary.
+// Can be set from the command line (-DOCAP_FIXED_POINT=1), see the target
+// lib-fixed in the Makefile.
+#ifndef OCAP_FIXED_POINT
+#define OCAP_FIXED_POINT 0
+#endif
+
+// Use the polynomial sin/cos and the Newton iteration for sqrt of
+// FastMath.c (1) instead of the C library (0), for microcontrollers with a
+// slow floating point math library. The maximum errors are listed in
+// FastMath.h, make bench measures them and the time per call.
+// The cone check uses the scalar version (no SIMD) in this case.
+// FAST_MATH_NEWTON_STEPS (1 ... 3) trades the accuracy of sqrt for cycles.
+// flightPathExtrapolationPrepare2rv subtracts nearly parallel unit vectors,
+// so it needs the full float precision: with 3 steps, the alarm timelines
+// of the test flights are the same within 2s, with 2 steps, about half of
+// them differ by more.
+#ifndef OCAP_FAST_MATH
+#define OCAP_FAST_MATH 0
+#endif
+#ifndef FAST_MATH_NEWTON_STEPS
+#define FAST_MATH_NEWTON_STEPS 3
+#endif
+
+
+// Local frame (LocalFrame.h): the origin is moved to our own position when
+// we are more than LOCAL_FRAME_REBASE_MTR away from it (horizontally).
+// Positions quantized to 16 bits have a resolution of
+// LOCAL_FRAME_QUANTUM_MTR and cover +/- 16km around the origin: our own
+// position plus the check limit of 8km (DIST_MTR_SQU_CHECK_LIMIT).
+#define LOCAL_FRAME_REBASE_MTR 4000
+#define LOCAL_FRAME_QUANTUM_MTR 0.5f
+
+
+// Default maximum number of flight objects that we can track (including
+// our own), see ocapCapacitiesInitDefault. The capacities of a context are
+// set at runtime with ocapContextInitWithMemory.
 #define FLIGHT_OBJECT_LIST_LENGTH 200
 
+// Look up the flight objects by ID with a hash index (1) or by a linear
+// search through the list (0).
+// The index is an open addressing hash table from the ID to the list
+// slot, with at least twice as many entries as flight objects to keep the
+// probe sequences short (2 bytes per entry).
+#define FLIGHT_OBJECT_LIST_ID_INDEX 1
+
+// Keep a uniform grid index over the received positions of the flight
+// objects (1), so that the prediction only visits the flight objects which
+// can come close to our own flight path. Meant for a large
+// flight object capacity, e.g. on ground stations.
+// The grid assumes a maximum speed of FLIGHT_OBJECT_LIST_GRID_V_MAX_MS,
+// faster flight objects are always visited. A flight object that comes into
+// reach again restarts its extrapolation from the received data.
+// The grid cells are hashed into FLIGHT_OBJECT_LIST_GRID_BUCKETS lists
+// (a power of 2, larger than the number of cells in reach).
+#define FLIGHT_OBJECT_LIST_GRID 0
+#define FLIGHT_OBJECT_LIST_GRID_CELL_MTR 8000
+#define FLIGHT_OBJECT_LIST_GRID_BUCKETS 1024
+#define FLIGHT_OBJECT_LIST_GRID_V_MAX_MS 100
+
 // Maximum number of seconds before we release a flight object.
 #define FLIGHT_OBJECT_TIME_TO_RELEASE_SEC 12
 
+// Keep the extrapolated flight path of other flight objects across
+// prediction iterations (1) or extrapolate it from scratch every second (0).
+// Without new data, the cached path is shifted by 1 second and only the
+// new last position is extrapolated.
+// Enabling the cache increases the memory footprint by a TFlightPathCache
+// per flight object (492 bytes with T_MAX_SEC 30) and 4 bytes in
+// TFlightObjectOther (88 to 92 bytes).
+#define FLIGHT_OBJECT_OTHER_PATH_CACHE 1
+
+// Store the cached flight paths as 16-bit positions in the local frame (1)
+// instead of float (0), see localFrameQuantize. The positions take
+// T_MAX_SEC * 6 bytes per flight object; with the extrapolation data, the
+// cache entry shrinks by about 41% (from 492 to 288 bytes with T_MAX_SEC 30).
+// The positions are rounded to LOCAL_FRAME_QUANTUM_MTR. A path that leaves
+// the range of the quantized positions isn't cached.
+#ifndef FLIGHT_OBJECT_OTHER_PATH_CACHE_QUANTIZED
+#define FLIGHT_OBJECT_OTHER_PATH_CACHE_QUANTIZED 0
+#endif
+
+// Evaluate the extrapolated flight paths in closed form (1) or by running
+// the extrapolation steps one by one (0, the results of earlier versions).
+// At ECEF magnitudes, the float rounding errors of the steps accumulate to
+// several meters after 30s; the closed form stays within the float resolution
+// of about 0.5m (see testFlightPathExtrapolationAccuracy in main.cpp).
+#define FLIGHT_PATH_EXTRAPOLATION_CLOSED_FORM 1
+
 
 // Iteration step in seconds for the prediction algorithm.
 // Needs to be fixed at 1 for the current implementation.
@@ -75,8 +162,57 @@
 #define ALARM_Z_OTHER_COMPENSATION_MILLI_V 2000
 
 
-// Maximum number of alarm states.
+// Skip the extrapolation and the cone check for flight objects that can't
+// get close enough for an alarm within T_MAX_SEC (1), based on bounding
+// boxes of both flight paths. The simulation doesn't get predicted flight
+// paths for skipped objects.
+#define PREDICTION_REACHABILITY_FILTER 1
+
+// Check flight objects on a straight line against our own straight flight
+// path by solving for the encounter (1) instead of checking all predicted
+// positions (0). The result is the same.
+// Not available in fixed point (the solver needs double precision).
+#if OCAP_FIXED_POINT == 1
+#define PREDICTION_LINEAR_SOLVER 0
+#else
+#define PREDICTION_LINEAR_SOLVER 1
+#endif
+
+// Use SIMD instructions for the cone check (1) or the scalar version (0).
+// AVX2 (if compiled with -mavx2) or SSE2 on x86, NEON on AArch64.
+// All variants produce identical results. Ignored with OCAP_FIXED_POINT
+// and OCAP_FAST_MATH.
+#define CONE_CHECK_SIMD 1
+
+// Maximum number of threads for predictionCalculateAlarmStatesParallel
+// (see TOcapCapacities.predictionThreads).
+// With 1, the function isn't available and the library doesn't need
+// pthreads. Each thread needs its own extrapolation data in the context.
+#ifndef PREDICTION_THREADS_MAX
+#define PREDICTION_THREADS_MAX 1
+#endif
+
+// Number of flight objects a prediction thread takes at a time.
+#define PREDICTION_THREAD_CHUNK 16
+
+
+// Default maximum number of alarm states, see ocapCapacitiesInitDefault.
 #define ALARM_STATE_LIST_LENGTH 5
 
+// Default maximum number of aircraft that the alarm service filters at the
+// same time (alarmServiceUpdate), see ocapCapacitiesInitDefault. An entry
+// stays for a few seconds after the last alarm (until its level has decayed).
+#define ALARM_SERVICE_LIST_LENGTH 8
+
+// Default and maximum length of the queue of received updates (RxQueue.h),
+// see ocapCapacitiesInitDefault.
+#define RX_QUEUE_LENGTH 64
+#define RX_QUEUE_LENGTH_MAX 65536
+
+// Default and maximum length of the queue of alarm events
+// (AlarmEventQueue.h), see ocapCapacitiesInitDefault.
+#define ALARM_EVENT_QUEUE_LENGTH 32
+#define ALARM_EVENT_QUEUE_LENGTH_MAX 65536
+
 
 #endif // __CONFIGURATION_H__
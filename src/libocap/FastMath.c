@@ -0,0 +1,169 @@
+//
+// FastMath.c
+//
+// OCAP - Open Collision Avoidance Protocol
+//
+// Approximations of sqrt, sin and cos, see FastMath.h.
+//
+// 17.10.2026 ASR  First version.
+//
+// Software License (BSD):
+// Copyright 2026 Classy Code GmbH.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contribu-
+//    tors may be used to endorse or promote products derived from this soft-
+//    ware without specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS “AS IS”
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+
+#include <math.h>
+#include <string.h>
+#include <inttypes.h>
+#include "FastMath.h"
+
+#if OCAP_FAST_MATH == 1
+// Larger arguments of sin/cos are passed to the C library, as the
+// reduction to [-pi/4, pi/4] loses precision.
+#define FAST_MATH_TRIG_MAX 1000.0f
+
+// pi/2 split into a part with few mantissa bits (n * hi is exact) and the rest.
+#define FAST_MATH_PI_HALF_HI 1.5703125f
+#define FAST_MATH_PI_HALF_LO 4.83826794897e-4f
+#define FAST_MATH_TWO_DIV_PI 0.636619772368f
+
+// Magic constant of the initial guess for 1/sqrt.
+#define FAST_MATH_RSQRT_MAGIC 0x5f375a86u
+
+
+static int fastMathReduce(float x, float *r);
+static float fastMathSinPolynomial(float r);
+static float fastMathCosPolynomial(float r);
+#endif
+
+
+#if OCAP_FAST_MATH == 1
+
+float fastMathSin(float x)
+{
+	if (x > FAST_MATH_TRIG_MAX || x < -FAST_MATH_TRIG_MAX) {
+		return sinf(x);
+	}
+	// sin(r + pi/2) = cos(r), sin(r + pi) = -sin(r), ...
+	float r;
+	int q = fastMathReduce(x, &r);
+	if (q == 0) {
+		return fastMathSinPolynomial(r);
+	} else if (q == 1) {
+		return fastMathCosPolynomial(r);
+	} else if (q == 2) {
+		return -fastMathSinPolynomial(r);
+	}
+	return -fastMathCosPolynomial(r);
+}
+
+float fastMathCos(float x)
+{
+	if (x > FAST_MATH_TRIG_MAX || x < -FAST_MATH_TRIG_MAX) {
+		return cosf(x);
+	}
+	// cos(r + pi/2) = -sin(r), cos(r + pi) = -cos(r), ...
+	float r;
+	int q = fastMathReduce(x, &r);
+	if (q == 0) {
+		return fastMathCosPolynomial(r);
+	} else if (q == 1) {
+		return -fastMathSinPolynomial(r);
+	} else if (q == 2) {
+		return -fastMathCosPolynomial(r);
+	}
+	return fastMathSinPolynomial(r);
+}
+
+float fastMathRsqrt(float v)
+{
+	// Initial guess from the halved exponent, then Newton steps
+	// y := y * (1.5 - 0.5 * v * y^2).
+	uint32_t i;
+	memcpy(&i, &v, sizeof(i));
+	i = FAST_MATH_RSQRT_MAGIC - (i >> 1);
+	float y;
+	memcpy(&y, &i, sizeof(y));
+
+	float vHalf = 0.5f * v;
+	for (int step = 0; step < FAST_MATH_NEWTON_STEPS; step++) {
+		y = y * (1.5f - vHalf * y * y);
+	}
+	return y;
+}
+
+float fastMathSqrt(float v)
+{
+	if (v <= 0) {
+		return 0;
+	}
+	return v * fastMathRsqrt(v);
+}
+
+// Returns the quadrant q (0 ... 3) and r in [-pi/4, pi/4] with
+// x = n * pi/2 + r, q = n mod 4.
+static int fastMathReduce(float x, float *r)
+{
+	int n = (int)(x * FAST_MATH_TWO_DIV_PI + (x < 0 ? -0.5f : 0.5f));
+	*r = (x - n * FAST_MATH_PI_HALF_HI) - n * FAST_MATH_PI_HALF_LO;
+	return n & 3;
+}
+
+// Taylor series up to r^9 resp. r^8 (Horner scheme).
+static float fastMathSinPolynomial(float r)
+{
+	float r2 = r * r;
+	return r * (1.0f + r2 * (-1.0f / 6 + r2 * (1.0f / 120
+		+ r2 * (-1.0f / 5040 + r2 * (1.0f / 362880)))));
+}
+
+static float fastMathCosPolynomial(float r)
+{
+	float r2 = r * r;
+	return 1.0f + r2 * (-0.5f + r2 * (1.0f / 24
+		+ r2 * (-1.0f / 720 + r2 * (1.0f / 40320))));
+}
+
+#else
+
+float fastMathSin(float x)
+{
+	return sinf(x);
+}
+
+float fastMathCos(float x)
+{
+	return cosf(x);
+}
+
+float fastMathRsqrt(float v)
+{
+	return 1.0f / sqrtf(v);
+}
+
+float fastMathSqrt(float v)
+{
+	return sqrtf(v);
+}
+
+#endif
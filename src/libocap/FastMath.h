@@ -0,0 +1,69 @@
+//
+// FastMath.h
+//
+// OCAP - Open Collision Avoidance Protocol
+//
+// Approximations of sqrt, sin and cos for microcontrollers with a slow
+// (or without) floating point math library, see OCAP_FAST_MATH in
+// Configuration.h. Without OCAP_FAST_MATH, the C library is used.
+//
+// 17.10.2026 ASR  First version.
+//
+// Software License (BSD):
+// Copyright 2026 Classy Code GmbH.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contribu-
+//    tors may be used to endorse or promote products derived from this soft-
+//    ware without specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS “AS IS”
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+
+#ifndef __FAST_MATH_H__
+#define __FAST_MATH_H__ 1
+
+#include "Configuration.h"
+
+// Maximum errors with OCAP_FAST_MATH (make bench, against double):
+//
+//   function          range            max. error    Newton steps
+//   fastMathSin/Cos   |x| <= pi        9.6e-8 abs    -
+//   fastMathSin/Cos   |x| <= 1000      1.1e-7 abs    -
+//   fastMathRsqrt     1e-3 ... 1e9     1.8e-3 rel    1
+//                                      4.8e-6 rel    2
+//                                      1.5e-7 rel    3
+//   fastMathSqrt      1e-3 ... 1e9     1.8e-3 rel    1
+//                                      4.8e-6 rel    2
+//                                      1.9e-7 rel    3
+//
+// For comparison, sinf and cosf have errors up to 3.3e-8, sqrtf 6e-8.
+// Arguments of sin/cos beyond +/- 1000 fall back to sinf/cosf.
+// The time per call depends on the platform (e.g. a hardware sqrt or
+// FMA), run make bench on the target.
+
+// Returns sin(x) or cos(x); polynomials after the reduction to [-pi/4, pi/4].
+float fastMathSin(float x);
+float fastMathCos(float x);
+
+// Returns 1/sqrt(v) for v > 0, with FAST_MATH_NEWTON_STEPS refinement steps.
+float fastMathRsqrt(float v);
+
+// Returns sqrt(v), 0 for v <= 0.
+float fastMathSqrt(float v);
+
+#endif // __FAST_MATH_H__
@@ -0,0 +1,172 @@
+//
+// FixedPoint.c
+//
+// OCAP - Open Collision Avoidance Protocol
+//
+// Fixed point arithmetic for the prediction on microcontrollers without
+// floating point unit, see OCAP_FIXED_POINT in Configuration.h.
+//
+// 17.10.2026 ASR  First version.
+//
+// Software License (BSD):
+// Copyright 2026 Classy Code GmbH.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contribu-
+//    tors may be used to endorse or promote products derived from this soft-
+//    ware without specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS “AS IS”
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+
+#include <math.h>
+#include "FixedPoint.h"
+
+// 2^31 as float: the smallest float that doesn't fit into int32.
+#define FIXED_FLOAT_LIMIT 2147483648.0f
+
+// pi/2 in Q30.
+#define FIXED_PI_HALF_Q30 1686629713
+
+// Taylor coefficients 1/n! in Q30.
+#define FIXED_INV_FAC_2 536870912
+#define FIXED_INV_FAC_3 178956971
+#define FIXED_INV_FAC_4 44739243
+#define FIXED_INV_FAC_5 8947849
+#define FIXED_INV_FAC_6 1491308
+#define FIXED_INV_FAC_7 213044
+#define FIXED_INV_FAC_8 26631
+#define FIXED_INV_FAC_9 2959
+#define FIXED_INV_FAC_10 296
+
+#define FIXED_ONE_Q30 (1 << 30)
+
+
+int32_t fixedFromFloat(float v, int shift)
+{
+	float scaled = roundf(v * (float)((int32_t)1 << shift));
+	if (scaled >= FIXED_FLOAT_LIMIT || scaled != scaled) {
+		return INT32_MAX;
+	}
+	if (scaled < -FIXED_FLOAT_LIMIT) {
+		return INT32_MIN;
+	}
+	return (int32_t)scaled;
+}
+
+float fixedToFloat(int32_t v, int shift)
+{
+	return (float)v * (1.0f / (float)((int32_t)1 << shift));
+}
+
+void fixedVectorFromVector(TFixedVector *target, TVector *source, int shift)
+{
+	target->x = fixedFromFloat(source->x, shift);
+	target->y = fixedFromFloat(source->y, shift);
+	target->z = fixedFromFloat(source->z, shift);
+}
+
+void fixedVectorToVector(TVector *target, TFixedVector *source, int shift)
+{
+	target->x = fixedToFloat(source->x, shift);
+	target->y = fixedToFloat(source->y, shift);
+	target->z = fixedToFloat(source->z, shift);
+}
+
+TFixedAngle fixedAngleFromRad(float rad)
+{
+	// Fraction of a full turn in [0, 1]; 1 (after rounding) wraps to 0.
+	float turns = rad * (float)(0.5 / M_PI);
+	turns -= floorf(turns);
+	return (TFixedAngle)(int64_t)(turns * 4294967296.0f);
+}
+
+int32_t fixedSaturate(int64_t v)
+{
+	if (v > INT32_MAX) {
+		return INT32_MAX;
+	}
+	if (v < INT32_MIN) {
+		return INT32_MIN;
+	}
+	return (int32_t)v;
+}
+
+int32_t fixedMultiply(int32_t a, int32_t b, int shift)
+{
+	int64_t product = (int64_t)a * b + ((int64_t)1 << (shift - 1));
+	return fixedSaturate(product >> shift);
+}
+
+void fixedSinCos(TFixedAngle angle, int32_t *sinQ30, int32_t *cosQ30)
+{
+	// angle = q quarter turns + x, x in [-pi/4, pi/4).
+	uint32_t q = ((angle + 0x20000000u) >> 30) & 3;
+	int32_t rest = (int32_t)(angle - (q << 30));
+	int32_t x = fixedMultiply(rest, FIXED_PI_HALF_Q30, 30);
+	int32_t x2 = fixedMultiply(x, x, 30);
+
+	// Taylor series up to x^9 resp. x^10 (Horner scheme).
+	int32_t s = FIXED_INV_FAC_9;
+	s = fixedMultiply(s, x2, 30) - FIXED_INV_FAC_7;
+	s = fixedMultiply(s, x2, 30) + FIXED_INV_FAC_5;
+	s = fixedMultiply(s, x2, 30) - FIXED_INV_FAC_3;
+	s = fixedMultiply(s, x2, 30) + FIXED_ONE_Q30;
+	s = fixedMultiply(s, x, 30);
+
+	int32_t c = -FIXED_INV_FAC_10;
+	c = fixedMultiply(c, x2, 30) + FIXED_INV_FAC_8;
+	c = fixedMultiply(c, x2, 30) - FIXED_INV_FAC_6;
+	c = fixedMultiply(c, x2, 30) + FIXED_INV_FAC_4;
+	c = fixedMultiply(c, x2, 30) - FIXED_INV_FAC_2;
+	c = fixedMultiply(c, x2, 30) + FIXED_ONE_Q30;
+
+	// sin(x + pi/2) = cos(x), cos(x + pi/2) = -sin(x).
+	if (q == 0) {
+		*sinQ30 = s;
+		*cosQ30 = c;
+	} else if (q == 1) {
+		*sinQ30 = c;
+		*cosQ30 = -s;
+	} else if (q == 2) {
+		*sinQ30 = -s;
+		*cosQ30 = -c;
+	} else {
+		*sinQ30 = -c;
+		*cosQ30 = s;
+	}
+}
+
+uint32_t fixedSqrt(uint32_t v)
+{
+	// Digit by digit (base 4).
+	uint32_t result = 0;
+	uint32_t bit = (uint32_t)1 << 30;
+	while (bit > v) {
+		bit >>= 2;
+	}
+	while (bit != 0) {
+		if (v >= result + bit) {
+			v -= result + bit;
+			result = (result >> 1) + bit;
+		} else {
+			result >>= 1;
+		}
+		bit >>= 2;
+	}
+	return result;
+}
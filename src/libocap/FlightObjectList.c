@@ -32,88 +32,377 @@
 // DAMAGE.
 //
 
+#include <math.h>
 #include "Configuration.h"
 #include "FlightObjectList.h"
+#include "InputRecorder.h"
+#include "OcapLog.h"
 
-static TFlightObjectOwn sFlightObjectOwn;
+// Handle of slot ix with the given generation.
+#define FLIGHT_OBJECT_LIST_HANDLE(generation, ix) \
+	((TFlightObjectHandle)(((uint32_t)(generation) << 16) | (uint32_t)((ix) + 1)))
+#define FLIGHT_OBJECT_LIST_HANDLE_GENERATION(handle) ((handle) >> 16)
+#define FLIGHT_OBJECT_LIST_HANDLE_IX(handle) ((int)((handle) & 0xffff) - 1)
 
-static TFlightObjectOther sFlightObjects[FLIGHT_OBJECT_LIST_LENGTH];
-static int sCount;
+#if FLIGHT_OBJECT_LIST_ID_INDEX == 1
+static int flightObjectListIndexHash(TOcapContext *ctx, uint32_t id);
+static int flightObjectListIndexFind(TOcapContext *ctx, uint32_t id);
+static void flightObjectListIndexRemove(TOcapContext *ctx, int pos);
+#endif
 
+#if FLIGHT_OBJECT_LIST_GRID == 1
+#define FLIGHT_OBJECT_LIST_GRID_MASK (FLIGHT_OBJECT_LIST_GRID_BUCKETS - 1)
+#if (FLIGHT_OBJECT_LIST_GRID_BUCKETS & FLIGHT_OBJECT_LIST_GRID_MASK) != 0
+#error "FLIGHT_OBJECT_LIST_GRID_BUCKETS must be a power of 2"
+#endif
+// Bucket of the flight objects which are faster than the grid assumes.
+#define FLIGHT_OBJECT_LIST_GRID_FAST FLIGHT_OBJECT_LIST_GRID_BUCKETS
 
-void flightObjectListInit(uint32_t idOwn)
+static int flightObjectListGridHash(int32_t cellX, int32_t cellY);
+static void flightObjectListGridInsert(TOcapContext *ctx, int ix, int bucket);
+static void flightObjectListGridRemove(TOcapContext *ctx, int ix);
+static void flightObjectListGridSelectBucket(
+	TOcapContext *ctx, int bucket, int32_t cellX, int32_t cellY);
+#endif
+
+void flightObjectListInit(TOcapContext *ctx, uint32_t idOwn)
 {
-	flightObjectOwnInit(&sFlightObjectOwn, idOwn);
+	inputRecorderRecordListInit(ctx, idOwn);
+
+	flightObjectOwnInit(&ctx->flightObjectOwn, idOwn);
 
-	sCount = 0;
-	// Start with all flight objects 'unallocated'.
-	for (int i = 0; i < FLIGHT_OBJECT_LIST_LENGTH; i++) {
-		TFlightObjectOther *f = &sFlightObjects[i];
+	ctx->flightObjectCount = 0;
+	ctx->flightObjectFreeFirst = 0;
+	// Start with all flight objects 'unallocated'; handles from before
+	// become invalid.
+	for (int i = 0; i < ctx->flightObjectCapacity; i++) {
+		TFlightObjectOther *f = &ctx->flightObjects[i];
 		f->state = FOS_UNALLOCATED;
+		f->handle = FLIGHT_OBJECT_LIST_HANDLE(
+			FLIGHT_OBJECT_LIST_HANDLE_GENERATION(f->handle) + 1, i);
+#if FLIGHT_OBJECT_OTHER_PATH_CACHE == 1
+		f->pathCacheIsValid = 0;
+#endif
+	}
+#if FLIGHT_OBJECT_LIST_ID_INDEX == 1
+	for (int i = 0; i <= ctx->flightObjectIndexMask; i++) {
+		ctx->flightObjectIndex[i] = 0;
 	}
+#endif
+#if FLIGHT_OBJECT_LIST_GRID == 1
+	for (int i = 0; i <= FLIGHT_OBJECT_LIST_GRID_BUCKETS; i++) {
+		ctx->flightObjectGridFirst[i] = 0;
+	}
+	for (int i = 0; i < ctx->flightObjectCapacity; i++) {
+		ctx->flightObjectGridBucket[i] = -1;
+	}
+#endif
 }
 
-TFlightObjectOwn *flightObjectListGetOwn(void)
+TFlightObjectOwn *flightObjectListGetOwn(TOcapContext *ctx)
 {
-	return &sFlightObjectOwn;
+	return &ctx->flightObjectOwn;
 }
 
-int flightObjectListGetOtherCount(void)
+int flightObjectListGetOtherCount(TOcapContext *ctx)
 {
-	return sCount;
+	return ctx->flightObjectCount;
 }
 
-TFlightObjectOther *flightObjectListGetOtherAtIndex(int i)
+TFlightObjectOther *flightObjectListGetOtherAtIndex(TOcapContext *ctx, int i)
 {
-	return &sFlightObjects[i];
+	return &ctx->flightObjects[i];
 }
 
-TFlightObjectOther *flightObjectListGetOther(uint32_t id)
+TFlightObjectOther *flightObjectListGetOther(TOcapContext *ctx, uint32_t id)
 {
-	for (int i = 0; i < sCount; i++) {
-		TFlightObjectOther *f = &sFlightObjects[i];
+#if FLIGHT_OBJECT_LIST_ID_INDEX == 1
+	int slot = ctx->flightObjectIndex[flightObjectListIndexFind(ctx, id)];
+	if (slot) {
+		return &ctx->flightObjects[slot - 1];
+	}
+	return 0L;
+#else
+	for (int i = 0; i < ctx->flightObjectCount; i++) {
+		TFlightObjectOther *f = &ctx->flightObjects[i];
 		if (f->id == id) {
 			return f;
 		}
 	}
 	return 0L;
+#endif
 }
 
-TFlightObjectOther *flightObjectListAddOther(uint32_t id)
+TFlightObjectOther *flightObjectListAddOther(TOcapContext *ctx, uint32_t id)
 {
-	// Return if the list is full.
-	if (sCount >= FLIGHT_OBJECT_LIST_LENGTH) {
+	inputRecorderRecordAddOther(ctx, id);
+
+	// Take a released slot, or the next unused one. Return if the list is full.
+	int ix;
+	if (ctx->flightObjectFreeFirst) {
+		ix = ctx->flightObjectFreeFirst - 1;
+		ctx->flightObjectFreeFirst = ctx->flightObjectFreeNext[ix];
+	} else if (ctx->flightObjectCount < ctx->flightObjectCapacity) {
+		ix = ctx->flightObjectCount++;
+	} else {
 		return 0;
 	}
 
-	// Add the entry at the end.
-	int ix = sCount++;
-	TFlightObjectOther *f = &sFlightObjects[ix];
+	TFlightObjectOther *f = &ctx->flightObjects[ix];
 	flightObjectOtherInit(f, id);
+#if FLIGHT_OBJECT_LIST_ID_INDEX == 1
+	int pos = flightObjectListIndexFind(ctx, id);
+	if (!ctx->flightObjectIndex[pos]) {
+		ctx->flightObjectIndex[pos] = ix + 1;
+	}
+#endif
 	return f;
 }
 
-void flightObjectListRemoveOtherAtIndex(int ix)
+void flightObjectListRemoveOtherAtIndex(TOcapContext *ctx, int ix)
 {
 	// Release the flight object.
-	TFlightObjectOther *f = &sFlightObjects[ix];
+	TFlightObjectOther *f = &ctx->flightObjects[ix];
 	if (f->state == FOS_UNALLOCATED) {
 		return;
 	}
 
-	// Fill the hole if we remove an inner entry.
-	int lastIx = sCount - 1;
-	if (ix < lastIx) {
-		// It's an inner entry; move the last entry to the inner.
-		TFlightObjectOther *lastF = &sFlightObjects[lastIx];
-		flightObjectOtherCopy(f, lastF);
-		flightObjectOtherRelease(lastF);
-	} else {
-		// It's the last entry, simply release it.
-		flightObjectOtherRelease(f);
+#if FLIGHT_OBJECT_LIST_GRID == 1
+	flightObjectListGridRemove(ctx, ix);
+#endif
+#if FLIGHT_OBJECT_LIST_ID_INDEX == 1
+	// Update the index while the ID is still in place.
+	int pos = flightObjectListIndexFind(ctx, f->id);
+	if (ctx->flightObjectIndex[pos] == ix + 1) {
+		flightObjectListIndexRemove(ctx, pos);
+	}
+#endif
+
+	// The other flight objects stay in their slots. The new generation
+	// invalidates the handles of f.
+	flightObjectOtherRelease(f);
+	f->handle = FLIGHT_OBJECT_LIST_HANDLE(
+		FLIGHT_OBJECT_LIST_HANDLE_GENERATION(f->handle) + 1, ix);
+	ctx->flightObjectFreeNext[ix] = ctx->flightObjectFreeFirst;
+	ctx->flightObjectFreeFirst = ix + 1;
+}
+
+void flightObjectListReleaseExpiredOthers(TOcapContext *ctx)
+{
+	for (int i = 0; i < ctx->flightObjectCount; i++) {
+		TFlightObjectOther *f = &ctx->flightObjects[i];
+		if (f->state != FOS_UNALLOCATED
+				&& f->timeSinceLastRxSec >= FLIGHT_OBJECT_TIME_TO_RELEASE_SEC) {
+			ocapLogStrInt("FLOBJ-RELEASE", f->id);
+			flightObjectListRemoveOtherAtIndex(ctx, i);
+		}
+	}
+}
+
+TFlightObjectHandle flightObjectListGetOtherHandle(TFlightObjectOther *f)
+{
+	return f->handle;
+}
+
+TFlightObjectOther *flightObjectListGetOtherByHandle(
+	TOcapContext *ctx, TFlightObjectHandle handle)
+{
+	int ix = FLIGHT_OBJECT_LIST_HANDLE_IX(handle);
+	if (ix < 0 || ix >= ctx->flightObjectCount) {
+		return 0L;
+	}
+	TFlightObjectOther *f = &ctx->flightObjects[ix];
+	if (f->handle != handle || f->state == FOS_UNALLOCATED) {
+		return 0L;
+	}
+	return f;
+}
+
+void flightObjectListShiftOrigin(TOcapContext *ctx, TVector *shift)
+{
+	flightObjectOwnShiftOrigin(&ctx->flightObjectOwn, shift);
+	for (int i = 0; i < ctx->flightObjectCount; i++) {
+		TFlightObjectOther *f = &ctx->flightObjects[i];
+		flightObjectOtherShiftOrigin(f, shift);
+#if FLIGHT_OBJECT_OTHER_PATH_CACHE == 1
+		flightObjectOtherShiftPathCache(f, &ctx->flightObjectPathCaches[i], shift);
+#endif
+#if FLIGHT_OBJECT_LIST_GRID == 1
+		// The grid cells are relative to the origin.
+		if (ctx->flightObjectGridBucket[i] >= 0) {
+			flightObjectListUpdateOtherGrid(ctx, f);
+		}
+#endif
+	}
+}
+
+#if FLIGHT_OBJECT_LIST_ID_INDEX == 1
+
+static int flightObjectListIndexHash(TOcapContext *ctx, uint32_t id)
+{
+	// Fibonacci hashing, the IDs are 24-bit ADS-L addresses.
+	return (int)((id * 2654435769u) >> 16) & ctx->flightObjectIndexMask;
+}
+
+// Returns the index position of the ID, or the empty position
+// where it would be inserted.
+static int flightObjectListIndexFind(TOcapContext *ctx, uint32_t id)
+{
+	int pos = flightObjectListIndexHash(ctx, id);
+	while (ctx->flightObjectIndex[pos]) {
+		if (ctx->flightObjects[ctx->flightObjectIndex[pos] - 1].id == id) {
+			break;
+		}
+		pos = (pos + 1) & ctx->flightObjectIndexMask;
+	}
+	return pos;
+}
+
+// Clears the index entry at pos and moves the following entries
+// of the probe sequence back, so that we don't need tombstones.
+static void flightObjectListIndexRemove(TOcapContext *ctx, int pos)
+{
+	int hole = pos;
+	for (;;) {
+		pos = (pos + 1) & ctx->flightObjectIndexMask;
+		int slot = ctx->flightObjectIndex[pos];
+		if (!slot) {
+			break;
+		}
+		// Move the entry unless its home position lies cyclically
+		// in (hole, pos].
+		int home = flightObjectListIndexHash(ctx, ctx->flightObjects[slot - 1].id);
+		int distHome = (pos - home) & ctx->flightObjectIndexMask;
+		int distHole = (pos - hole) & ctx->flightObjectIndexMask;
+		if (distHome >= distHole) {
+			ctx->flightObjectIndex[hole] = slot;
+			hole = pos;
+		}
+	}
+	ctx->flightObjectIndex[hole] = 0;
+}
+
+#endif
+
+#if FLIGHT_OBJECT_LIST_GRID == 1
+
+void flightObjectListUpdateOtherGrid(TOcapContext *ctx, TFlightObjectOther *f)
+{
+	int ix = (int)(f - ctx->flightObjects);
+	flightObjectListGridRemove(ctx, ix);
+
+	// The extrapolated flight paths stay within 2*v*t of the received
+	// position (see Prediction.c); faster flight objects are always visited.
+	float vMsSqu = vectorMultiplyDot(&f->rxVel, &f->rxVel);
+	if (vMsSqu > (float)FLIGHT_OBJECT_LIST_GRID_V_MAX_MS * FLIGHT_OBJECT_LIST_GRID_V_MAX_MS) {
+		flightObjectListGridInsert(ctx, ix, FLIGHT_OBJECT_LIST_GRID_FAST);
+		return;
+	}
+
+	int32_t cellX = (int32_t)floorf(f->rxPos.x / FLIGHT_OBJECT_LIST_GRID_CELL_MTR);
+	int32_t cellY = (int32_t)floorf(f->rxPos.y / FLIGHT_OBJECT_LIST_GRID_CELL_MTR);
+	ctx->flightObjectGridCellX[ix] = cellX;
+	ctx->flightObjectGridCellY[ix] = cellY;
+	flightObjectListGridInsert(ctx, ix, flightObjectListGridHash(cellX, cellY));
+}
+
+void flightObjectListSelectOthers(TOcapContext *ctx, TVector *min, TVector *max)
+{
+	for (int i = 0; i < (ctx->flightObjectCapacity + 31) / 32; i++) {
+		ctx->flightObjectGridSelected[i] = 0;
 	}
 
-	sCount--;
-	return;
+	int32_t cellXMin = (int32_t)floorf(min->x / FLIGHT_OBJECT_LIST_GRID_CELL_MTR);
+	int32_t cellYMin = (int32_t)floorf(min->y / FLIGHT_OBJECT_LIST_GRID_CELL_MTR);
+	int32_t cellXMax = (int32_t)floorf(max->x / FLIGHT_OBJECT_LIST_GRID_CELL_MTR);
+	int32_t cellYMax = (int32_t)floorf(max->y / FLIGHT_OBJECT_LIST_GRID_CELL_MTR);
+
+	// If the area covers more cells than buckets, we select everything.
+	if ((int64_t)(cellXMax - cellXMin + 1) * (cellYMax - cellYMin + 1)
+			> FLIGHT_OBJECT_LIST_GRID_BUCKETS) {
+		flightObjectListSelectAllOthers(ctx);
+		return;
+	}
+
+	for (int32_t cellX = cellXMin; cellX <= cellXMax; cellX++) {
+		for (int32_t cellY = cellYMin; cellY <= cellYMax; cellY++) {
+			flightObjectListGridSelectBucket(ctx,
+				flightObjectListGridHash(cellX, cellY), cellX, cellY);
+		}
+	}
+	flightObjectListGridSelectBucket(ctx, FLIGHT_OBJECT_LIST_GRID_FAST, 0, 0);
+}
+
+void flightObjectListSelectAllOthers(TOcapContext *ctx)
+{
+	for (int i = 0; i < ctx->flightObjectCount; i++) {
+		ctx->flightObjectGridSelected[i / 32] |= 1u << (i % 32);
+	}
+}
+
+int flightObjectListGetNextSelected(TOcapContext *ctx, int i)
+{
+	while (i < ctx->flightObjectCount) {
+		uint32_t bits = ctx->flightObjectGridSelected[i / 32] >> (i % 32);
+		if (!bits) {
+			// Skip the rest of the word.
+			i = (i / 32 + 1) * 32;
+			continue;
+		}
+		while (!(bits & 1)) {
+			bits >>= 1;
+			i++;
+		}
+		return i;
+	}
+	return ctx->flightObjectCount;
+}
+
+static int flightObjectListGridHash(int32_t cellX, int32_t cellY)
+{
+	return (int)(((uint32_t)cellX * 73856093u) ^ ((uint32_t)cellY * 19349663u))
+		& FLIGHT_OBJECT_LIST_GRID_MASK;
+}
+
+static void flightObjectListGridInsert(TOcapContext *ctx, int ix, int bucket)
+{
+	ctx->flightObjectGridBucket[ix] = bucket;
+	ctx->flightObjectGridNext[ix] = ctx->flightObjectGridFirst[bucket];
+	ctx->flightObjectGridFirst[bucket] = ix + 1;
+}
+
+static void flightObjectListGridRemove(TOcapContext *ctx, int ix)
+{
+	int bucket = ctx->flightObjectGridBucket[ix];
+	if (bucket < 0) {
+		return;
+	}
+	ctx->flightObjectGridBucket[ix] = -1;
+
+	uint16_t *link = &ctx->flightObjectGridFirst[bucket];
+	while (*link) {
+		if (*link == ix + 1) {
+			*link = ctx->flightObjectGridNext[ix];
+			return;
+		}
+		link = &ctx->flightObjectGridNext[*link - 1];
+	}
+}
+
+// Selects the flight objects of the bucket in the given cell
+// (all of them for the fast bucket).
+static void flightObjectListGridSelectBucket(
+	TOcapContext *ctx, int bucket, int32_t cellX, int32_t cellY)
+{
+	for (int slot = ctx->flightObjectGridFirst[bucket]; slot;
+			slot = ctx->flightObjectGridNext[slot - 1]) {
+		int ix = slot - 1;
+		if (bucket == FLIGHT_OBJECT_LIST_GRID_FAST
+				|| (ctx->flightObjectGridCellX[ix] == cellX
+					&& ctx->flightObjectGridCellY[ix] == cellY)) {
+			ctx->flightObjectGridSelected[ix / 32] |= 1u << (ix % 32);
+		}
+	}
 }
 
+#endif
@@ -38,19 +38,61 @@
 #include <inttypes.h>
 #include "FlightObjectOwn.h"
 #include "FlightObjectOther.h"
+#include "OcapContext.h"
 
-void flightObjectListInit(uint32_t idOwn);
+// Releases all flight objects and sets the ID of our own one. Called by
+// ocapContextInitWithMemory with ID 0.
+void flightObjectListInit(TOcapContext *ctx, uint32_t idOwn);
 
-TFlightObjectOwn *flightObjectListGetOwn(void);
+TFlightObjectOwn *flightObjectListGetOwn(TOcapContext *ctx);
 
-int flightObjectListGetOtherCount(void);
-TFlightObjectOther *flightObjectListGetOtherAtIndex(int i);
+// The other flight objects stay in their list slot until they are removed,
+// so pointers to them remain valid; a removed slot is reused for the next
+// new flight object. Hold a handle instead of a pointer across predictions
+// to detect the reuse.
 
-TFlightObjectOther *flightObjectListGetOther(uint32_t id);
+// Returns the number of slots in use so far. Slots of removed flight objects
+// are in the state FOS_UNALLOCATED.
+int flightObjectListGetOtherCount(TOcapContext *ctx);
+TFlightObjectOther *flightObjectListGetOtherAtIndex(TOcapContext *ctx, int i);
 
-// Returns the index of the new flight object, or -1, if there was no space.
-TFlightObjectOther *flightObjectListAddOther(uint32_t id);
+TFlightObjectOther *flightObjectListGetOther(TOcapContext *ctx, uint32_t id);
 
-void flightObjectListRemoveOtherAtIndex(int ix);
+// Returns the new flight object, or 0 if there was no space.
+TFlightObjectOther *flightObjectListAddOther(TOcapContext *ctx, uint32_t id);
+
+void flightObjectListRemoveOtherAtIndex(TOcapContext *ctx, int ix);
+
+// Removes the flight objects for which we didn't receive data for
+// FLIGHT_OBJECT_TIME_TO_RELEASE_SEC. Called at the start of the prediction,
+// so that the alarm states of a prediction stay valid until the next one.
+void flightObjectListReleaseExpiredOthers(TOcapContext *ctx);
+
+// Returns the handle of f (valid until f is removed).
+TFlightObjectHandle flightObjectListGetOtherHandle(TFlightObjectOther *f);
+
+// Returns the flight object of the handle, or 0 if it has been removed
+// in the meantime. The generation has 16 bits, so a handle must not be
+// kept while the same slot is reused 65536 times.
+TFlightObjectOther *flightObjectListGetOtherByHandle(
+	TOcapContext *ctx, TFlightObjectHandle handle);
+
+// Subtracts shift from the stored positions of all flight objects, see
+// calculateOwnDataFromGlobalGpsInfo.
+void flightObjectListShiftOrigin(TOcapContext *ctx, TVector *shift);
+
+#if FLIGHT_OBJECT_LIST_GRID == 1
+// Call this after the received position or velocity of f has changed.
+void flightObjectListUpdateOtherGrid(TOcapContext *ctx, TFlightObjectOther *f);
+
+// Selects the flight objects whose received position lies in the grid
+// cells covering min..max (x and y only), plus the fast flight objects.
+void flightObjectListSelectOthers(TOcapContext *ctx, TVector *min, TVector *max);
+
+void flightObjectListSelectAllOthers(TOcapContext *ctx);
+
+// Returns the first selected index >= i, or the number of flight objects.
+int flightObjectListGetNextSelected(TOcapContext *ctx, int i);
+#endif
 
 #endif // __FLIGHT_OBJECT_LIST_H__
@@ -48,6 +48,12 @@ void flightObjectOtherInit(TFlightObjectOther *f, uint32_t id)
 	vectorClear(&f->rxPos);
 	vectorClear(&f->rxVel);
 	vectorClear(&f->z);
+#if FLIGHT_OBJECT_LIST_GRID == 1
+	f->predictionNr = 0;
+#endif
+#if FLIGHT_OBJECT_OTHER_PATH_CACHE == 1
+	f->pathCacheIsValid = 0;
+#endif
 }
 
 void flightObjectOtherRelease(TFlightObjectOther *f)
@@ -71,6 +77,15 @@ void flightObjectOtherCopy(TFlightObjectOther *target, TFlightObjectOther *sourc
 	vectorCopy(&target->vel_i0, &source->vel_i0);
 
 	vectorCopy(&target->z, &source->z);
+
+#if FLIGHT_OBJECT_LIST_GRID == 1
+	target->predictionNr = source->predictionNr;
+#endif
+
+#if FLIGHT_OBJECT_OTHER_PATH_CACHE == 1
+	// Rather recalculate the path than copy it.
+	target->pathCacheIsValid = 0;
+#endif
 }
 
 void flightObjectOtherActivateRxData(TFlightObjectOther *f)
@@ -80,3 +95,33 @@ void flightObjectOtherActivateRxData(TFlightObjectOther *f)
 	vectorCopy(&f->vel_i0, &f->rxVel);
 }
 
+void flightObjectOtherShiftOrigin(TFlightObjectOther *f, TVector *shift)
+{
+	vectorSubtractVector(&f->pos_i0, shift);
+	vectorSubtractVector(&f->rxPos, shift);
+	vectorSubtractVector(&f->z, shift);
+}
+
+#if FLIGHT_OBJECT_OTHER_PATH_CACHE == 1
+void flightObjectOtherShiftPathCache(TFlightObjectOther *f, TFlightPathCache *c, TVector *shift)
+{
+	if (!f->pathCacheIsValid) {
+		return;
+	}
+	flightPathExtrapolationShiftOrigin(&c->fpeRx, shift);
+#if FLIGHT_OBJECT_OTHER_PATH_CACHE_QUANTIZED == 1
+	// The shift is in whole meters, so this is exact unless the path
+	// leaves the range of the quantized positions.
+	for (int t = 0; t < T_MAX_SEC; t++) {
+		TVector pos;
+		localFrameDequantize(&c->path[t], &pos);
+		vectorSubtractVector(&pos, shift);
+		if (!localFrameQuantize(&pos, &c->path[t])) {
+			f->pathCacheIsValid = 0;
+		}
+	}
+#else
+	flightPathExtrapolationShiftPath(&c->path, shift);
+#endif
+}
+#endif
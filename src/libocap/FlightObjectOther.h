@@ -37,13 +37,42 @@
 #define __FLIGHT_OBJECT_OTHER_H__ 1
 
 #include <inttypes.h>
+#include "Configuration.h"
 #include "Vector.h"
 #include "FlightObjectState.h"
 #include "FlightPathExtrapolation.h"
+#include "LocalFrame.h"
+
+#if FLIGHT_OBJECT_OTHER_PATH_CACHE == 1
+// Extrapolated flight path, kept across prediction iterations.
+// The caches are kept in a separate table of the context (one per list
+// slot), so that the flight objects which are out of reach don't pull them
+// through the cache; only the valid flag is in TFlightObjectOther.
+typedef struct {
+	// Seconds from the rx timestamp to "now" when the path was calculated.
+	int32_t deltaSec;
+	// Extrapolation data after the preparation (at the rx timestamp).
+	TFlightPathExtrapolationData fpeRx;
+	// Predicted positions for t = 0 ... T_MAX_SEC-1.
+#if FLIGHT_OBJECT_OTHER_PATH_CACHE_QUANTIZED == 1
+	TLocalFrameQuantizedPos path[T_MAX_SEC];
+#else
+	TFlightPath path;
+#endif
+} TFlightPathCache;
+#endif
+
+// Handle of a flight object: generation (high 16 bits) and list slot + 1
+// (low 16 bits), see flightObjectListGetOtherByHandle. 0 is no flight object.
+typedef uint32_t TFlightObjectHandle;
 
 typedef struct {
 	uint32_t id; // 0x004E7593
 
+	// Handle of the list slot; not changed by flightObjectOtherInit, so that
+	// the generation survives the release of the slot.
+	TFlightObjectHandle handle;
+
 	// Current state.
 	EFlightObjectState state;
 
@@ -65,6 +94,17 @@ typedef struct {
 	TVector z;
 	EOcapPathModel pathModel;
 
+#if FLIGHT_OBJECT_LIST_GRID == 1
+	// Last prediction iteration that visited the flight object.
+	uint32_t predictionNr;
+#endif
+
+#if FLIGHT_OBJECT_OTHER_PATH_CACHE == 1
+	// Extrapolated flight path in the cache of the list slot
+	// (TOcapContext.flightObjectPathCaches); invalidated when new data arrives.
+	int pathCacheIsValid;
+#endif
+
 } TFlightObjectOther;
 
 
@@ -75,5 +115,13 @@ void flightObjectOtherCopy(TFlightObjectOther *target, TFlightObjectOther *sourc
 
 void flightObjectOtherActivateRxData(TFlightObjectOther *f);
 
+// Subtracts shift from all stored positions (re-base of the local frame).
+void flightObjectOtherShiftOrigin(TFlightObjectOther *f, TVector *shift);
+
+#if FLIGHT_OBJECT_OTHER_PATH_CACHE == 1
+// The same for the path cache c of f, if it is valid.
+void flightObjectOtherShiftPathCache(TFlightObjectOther *f, TFlightPathCache *c, TVector *shift);
+#endif
+
 #endif // __FLIGHT_OBJECT_OTHER_H__
 
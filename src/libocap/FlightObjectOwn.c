@@ -131,3 +131,14 @@ void flightObjectOwnActivateModel(TFlightObjectOwn *f, TVector *newZ, EOcapPathM
 	vectorMultiplyScalar(&f->z_avg, 1.0f / imax);
 }
 
+void flightObjectOwnShiftOrigin(TFlightObjectOwn *f, TVector *shift)
+{
+	for (int i = 0; i < FLIGHT_OBJECT_OWN_EXTRAPOLATION_DEPTH_SEC; i++) {
+		vectorSubtractVector(&f->pos_i[i], shift);
+	}
+	vectorSubtractVector(&f->rxPos, shift);
+	for (int i = 0; i < FLIGHT_OBJECT_OWN_Z_AVERAGING_SEC; i++) {
+		vectorSubtractVector(&f->z_i[i], shift);
+	}
+	vectorSubtractVector(&f->z_avg, shift);
+}
@@ -82,4 +82,7 @@ void flightObjectOwnActivateRxData(TFlightObjectOwn *f);
 
 void flightObjectOwnActivateModel(TFlightObjectOwn *f, TVector *newZ, EOcapPathModel newModel);
 
+// Subtracts shift from all stored positions (re-base of the local frame).
+void flightObjectOwnShiftOrigin(TFlightObjectOwn *f, TVector *shift);
+
 #endif // __FLIGHT_OBJECT_OWN_H__
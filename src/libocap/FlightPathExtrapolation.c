@@ -33,7 +33,9 @@
 // DAMAGE.
 //
 
+#include "Configuration.h"
 #include "FlightPathExtrapolation.h"
+#include "FastMath.h"
 #include "OcapLog.h"
 
 #define ABS_D(X) ((X < 0) ? (-X) : (X))
@@ -42,6 +44,34 @@
 static void flightPathExtrapolationFinalizePreparation(
 		TFlightPathExtrapolationData *fpe);
 
+#if OCAP_FIXED_POINT == 1
+// Parameters of the closed-form extrapolation in fixed point.
+typedef struct {
+	EOcapPathModel predictionModel;
+	// Linear: _r(t)_ := _ri_ + t * _vi_ (_vi_ in FIXED_VEL_SHIFT).
+	TFixedVector ri;
+	TFixedVector vi;
+	// Spheric: _Z_.
+	// Arc: _r(t)_ := _Z_ + cos(k*t) * _d_ + sin(k*t) * _w_,
+	// with _d_ := _ri_ - _Z_ and _w_ := _vi_ / k.
+	TFixedVector z;
+	TFixedVector d;
+	TFixedVector w;
+	TFixedAngle k;
+} TFlightPathExtrapolationFixed;
+
+static void flightPathExtrapolationPrepareFixed(
+	TFlightPathExtrapolationData *fpe, TFlightPathExtrapolationFixed *fx);
+
+static void flightPathExtrapolationEvaluateFixed(
+	TFlightPathExtrapolationFixed *fx, int32_t tSec, TFixedVector *pos);
+
+static int32_t flightPathExtrapolationLinearFixed(int32_t r, int32_t v, int32_t tSec);
+
+static int32_t flightPathExtrapolationArcFixed(
+	int32_t z, int32_t d, int32_t w, int32_t sinQ30, int32_t cosQ30);
+#endif
+
 
 // Initialization step with 2x rv.
 // Fills z_vec, v, r, isCurve.
@@ -259,6 +289,167 @@ void flightPathExtrapolationExecute(
 	vectorCopy(&fpe->vi_vec, &tmp_new_v_vec);
 }
 
+void flightPathExtrapolationEvaluate(
+	TFlightPathExtrapolationData *fpe, float tSec, TVector *pos, TVector *vel)
+{
+#if FLIGHT_PATH_EXTRAPOLATION_CLOSED_FORM == 0
+	// Run the extrapolation steps on a copy (tSec is rounded down to full seconds).
+	TFlightPathExtrapolationData tmp = *fpe;
+	for (int t = 0; t < (int)tSec; t++) {
+		flightPathExtrapolationExecute(&tmp);
+	}
+	vectorCopy(pos, &tmp.ri_vec);
+	vectorCopy(vel, &tmp.vi_vec);
+#else
+	vectorCopy(vel, &fpe->vi_vec);
+
+	if (fpe->predictionModel == OCAP_PATH_MODEL_LINEAR) {
+		// _r(t)_ := _ri_ + t * _vi_
+		vectorCopy(pos, &fpe->vi_vec);
+		vectorMultiplyScalar(pos, tSec);
+		vectorAddVector(pos, &fpe->ri_vec);
+		return;
+	}
+
+	if (fpe->predictionModel == OCAP_PATH_MODEL_SPHERIC) {
+		// Assume the aircraft is static in point z.
+		vectorCopy(pos, tSec > 0 ? &fpe->z_vec : &fpe->ri_vec);
+		return;
+	}
+
+	// Each step of flightPathExtrapolationExecute maps (_d_, _v_), with
+	// _d_ := _r_ - _Z_, linearly onto
+	//   _d(new)_ := cos(alpha) * _d_ + theta * _v_
+	//   _v(new)_ := -sin(alpha)^2/theta * _d_ + cos(alpha) * _v_
+	// This is a rotation by alpha in (_d_, _v_/k) with k := sin(alpha)/theta = v/r,
+	// so t steps are a rotation by t * alpha:
+	//   _d(t)_ := cos(t*alpha) * _d_ + sin(t*alpha)/k * _v_
+	//   _v(t)_ := -k*sin(t*alpha) * _d_ + cos(t*alpha) * _v_
+	// alpha := v/r per second, hence k = alpha.
+	float k = fpe->v / fpe->r;
+	float c = fastMathCos(k * tSec);
+	float s = fastMathSin(k * tSec);
+
+	TVector d_vec;
+	vectorCopy(&d_vec, &fpe->ri_vec);
+	vectorSubtractVector(&d_vec, &fpe->z_vec);
+
+	TVector tmp_vec;
+
+	// _r(t)_ := _Z_ + _d(t)_
+	vectorCopy(pos, &d_vec);
+	vectorMultiplyScalar(pos, c);
+	vectorCopy(&tmp_vec, &fpe->vi_vec);
+	vectorMultiplyScalar(&tmp_vec, s / k);
+	vectorAddVector(pos, &tmp_vec);
+	vectorAddVector(pos, &fpe->z_vec);
+
+	// _v(t)_
+	vectorMultiplyScalar(vel, c);
+	vectorCopy(&tmp_vec, &d_vec);
+	vectorMultiplyScalar(&tmp_vec, -k * s);
+	vectorAddVector(vel, &tmp_vec);
+#endif
+}
+
+void flightPathExtrapolationEvaluatePath(TFlightPathExtrapolationData *fpe,
+	int32_t startSec, TFlightPath *path, int tFrom, int tTo)
+{
+#if OCAP_FIXED_POINT == 1
+	TFlightPathExtrapolationFixed fx;
+	flightPathExtrapolationPrepareFixed(fpe, &fx);
+	for (int t = tFrom; t < tTo; t += T_DELTA_SEC) {
+		TFixedVector pos;
+		flightPathExtrapolationEvaluateFixed(&fx, startSec + t, &pos);
+		path->x[t] = pos.x;
+		path->y[t] = pos.y;
+		path->z[t] = pos.z;
+	}
+#else
+	for (int t = tFrom; t < tTo; t += T_DELTA_SEC) {
+		TVector pos;
+		TVector vel;
+		flightPathExtrapolationEvaluate(fpe, startSec + t, &pos, &vel);
+		flightPathExtrapolationSetPathPosition(path, t, &pos);
+	}
+#endif
+	flightPathExtrapolationClearPadding(path);
+}
+
+void flightPathExtrapolationGetPathPosition(TFlightPath *path, int t, TVector *pos)
+{
+#if OCAP_FIXED_POINT == 1
+	pos->x = fixedToFloat(path->x[t], FIXED_POS_SHIFT);
+	pos->y = fixedToFloat(path->y[t], FIXED_POS_SHIFT);
+	pos->z = fixedToFloat(path->z[t], FIXED_POS_SHIFT);
+#else
+	pos->x = path->x[t];
+	pos->y = path->y[t];
+	pos->z = path->z[t];
+#endif
+}
+
+void flightPathExtrapolationSetPathPosition(TFlightPath *path, int t, TVector *pos)
+{
+#if OCAP_FIXED_POINT == 1
+	path->x[t] = fixedFromFloat(pos->x, FIXED_POS_SHIFT);
+	path->y[t] = fixedFromFloat(pos->y, FIXED_POS_SHIFT);
+	path->z[t] = fixedFromFloat(pos->z, FIXED_POS_SHIFT);
+#else
+	path->x[t] = pos->x;
+	path->y[t] = pos->y;
+	path->z[t] = pos->z;
+#endif
+}
+
+void flightPathExtrapolationClearPadding(TFlightPath *path)
+{
+	for (int t = T_MAX_SEC; t < FLIGHT_PATH_LENGTH; t++) {
+		path->x[t] = 0;
+		path->y[t] = 0;
+		path->z[t] = 0;
+	}
+}
+
+void flightPathExtrapolationShiftOrigin(TFlightPathExtrapolationData *fpe, TVector *shift)
+{
+	// r_z_vec and the velocities are relative.
+	vectorSubtractVector(&fpe->r0_vec, shift);
+	vectorSubtractVector(&fpe->ri_vec, shift);
+	vectorSubtractVector(&fpe->z_vec, shift);
+}
+
+void flightPathExtrapolationShiftPath(TFlightPath *path, TVector *shift)
+{
+	TVector pos;
+	for (int t = 0; t < T_MAX_SEC; t++) {
+		flightPathExtrapolationGetPathPosition(path, t, &pos);
+		vectorSubtractVector(&pos, shift);
+		flightPathExtrapolationSetPathPosition(path, t, &pos);
+	}
+}
+
+int flightPathExtrapolationEqualsParameters(
+	TFlightPathExtrapolationData *fpe1, TFlightPathExtrapolationData *fpe2)
+{
+	// Only compare the data used by flightPathExtrapolationExecute.
+	if (fpe1->predictionModel != fpe2->predictionModel
+			|| !vectorEqualsVector(&fpe1->ri_vec, &fpe2->ri_vec)
+			|| !vectorEqualsVector(&fpe1->vi_vec, &fpe2->vi_vec)) {
+		return 0;
+	}
+	if (fpe1->predictionModel == OCAP_PATH_MODEL_LINEAR) {
+		return 1;
+	}
+	if (!vectorEqualsVector(&fpe1->z_vec, &fpe2->z_vec)) {
+		return 0;
+	}
+	if (fpe1->predictionModel == OCAP_PATH_MODEL_SPHERIC) {
+		return 1;
+	}
+	return fpe1->theta == fpe2->theta && fpe1->t_div_r == fpe2->t_div_r;
+}
+
 // Finalize the preparation by calculating theta and t_div_r.
 static void flightPathExtrapolationFinalizePreparation(
 		TFlightPathExtrapolationData *fpe)
@@ -268,11 +459,78 @@ static void flightPathExtrapolationFinalizePreparation(
 
 	// alpha, theta
 	float alpha = v / r;
-	float a = r * sinf(alpha); // TODO: Taylor expansion
+	float a = r * fastMathSin(alpha);
 	fpe->theta = a / v;
-	fpe->t_div_r = 1.0 - cosf(alpha); // TODO: Taylor expansion
+	fpe->t_div_r = 1.0 - fastMathCos(alpha);
 
 	// printf("    a        = %8.4f\n", a);
 	// printf("    theta    = %8.4f\n", fpe->theta);
 	// printf("    t_div_r  = %8.4f\n", fpe->t_div_r);
 }
+
+#if OCAP_FIXED_POINT == 1
+// The only float operations per path (see flightPathExtrapolationEvaluate
+// for the closed form).
+static void flightPathExtrapolationPrepareFixed(
+	TFlightPathExtrapolationData *fpe, TFlightPathExtrapolationFixed *fx)
+{
+	fx->predictionModel = fpe->predictionModel;
+	fixedVectorFromVector(&fx->ri, &fpe->ri_vec, FIXED_POS_SHIFT);
+	fixedVectorFromVector(&fx->vi, &fpe->vi_vec, FIXED_VEL_SHIFT);
+	fixedVectorFromVector(&fx->z, &fpe->z_vec, FIXED_POS_SHIFT);
+
+	if (fx->predictionModel != OCAP_PATH_MODEL_ARC) {
+		return;
+	}
+	float k = fpe->v / fpe->r;
+	fx->d.x = fixedSaturate((int64_t)fx->ri.x - fx->z.x);
+	fx->d.y = fixedSaturate((int64_t)fx->ri.y - fx->z.y);
+	fx->d.z = fixedSaturate((int64_t)fx->ri.z - fx->z.z);
+	TVector w_vec;
+	vectorCopy(&w_vec, &fpe->vi_vec);
+	vectorMultiplyScalar(&w_vec, 1.0f / k);
+	fixedVectorFromVector(&fx->w, &w_vec, FIXED_POS_SHIFT);
+	fx->k = fixedAngleFromRad(k);
+}
+
+static void flightPathExtrapolationEvaluateFixed(
+	TFlightPathExtrapolationFixed *fx, int32_t tSec, TFixedVector *pos)
+{
+	if (fx->predictionModel == OCAP_PATH_MODEL_LINEAR) {
+		pos->x = flightPathExtrapolationLinearFixed(fx->ri.x, fx->vi.x, tSec);
+		pos->y = flightPathExtrapolationLinearFixed(fx->ri.y, fx->vi.y, tSec);
+		pos->z = flightPathExtrapolationLinearFixed(fx->ri.z, fx->vi.z, tSec);
+		return;
+	}
+
+	if (fx->predictionModel == OCAP_PATH_MODEL_SPHERIC) {
+		*pos = tSec > 0 ? fx->z : fx->ri;
+		return;
+	}
+
+	// The binary angle wraps around at 2*pi.
+	int32_t s;
+	int32_t c;
+	fixedSinCos(fx->k * (TFixedAngle)tSec, &s, &c);
+	pos->x = flightPathExtrapolationArcFixed(fx->z.x, fx->d.x, fx->w.x, s, c);
+	pos->y = flightPathExtrapolationArcFixed(fx->z.y, fx->d.y, fx->w.y, s, c);
+	pos->z = flightPathExtrapolationArcFixed(fx->z.z, fx->d.z, fx->w.z, s, c);
+}
+
+// Returns r + t * v for one axis.
+static int32_t flightPathExtrapolationLinearFixed(int32_t r, int32_t v, int32_t tSec)
+{
+	const int shift = FIXED_VEL_SHIFT - FIXED_POS_SHIFT;
+	int64_t dist = ((int64_t)v * tSec + (1 << (shift - 1))) >> shift;
+	return fixedSaturate(r + dist);
+}
+
+// Returns z + cos * d + sin * w for one axis.
+static int32_t flightPathExtrapolationArcFixed(
+	int32_t z, int32_t d, int32_t w, int32_t sinQ30, int32_t cosQ30)
+{
+	int64_t dist = (int64_t)d * cosQ30 + (int64_t)w * sinQ30
+		+ ((int64_t)1 << (FIXED_TRIG_SHIFT - 1));
+	return fixedSaturate(z + (dist >> FIXED_TRIG_SHIFT));
+}
+#endif
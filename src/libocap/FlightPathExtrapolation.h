@@ -36,7 +36,9 @@
 #ifndef __FLIGHT_PATH_EXTRAPOLATION_H__
 #define __FLIGHT_PATH_EXTRAPOLATION_H__ 1
 
+#include "Configuration.h"
 #include "Vector.h"
+#include "FixedPoint.h"
 
 typedef enum {
 	OCAP_PATH_MODEL_LINEAR = 0,
@@ -45,6 +47,30 @@ typedef enum {
 	// Reserved 3
 } EOcapPathModel;
 
+// Number of samples in TFlightPath: T_MAX_SEC rounded up to a multiple of 8
+// (the number of floats in the widest SIMD register used by ConeCheck.c).
+#define FLIGHT_PATH_LENGTH ((T_MAX_SEC + 7) / 8 * 8)
+
+#if OCAP_FIXED_POINT == 1
+// Position coordinate in 1/16m, see FIXED_POS_SHIFT.
+typedef int32_t TFlightPathCoord;
+#else
+typedef float TFlightPathCoord;
+#endif
+
+// Predicted positions for t = 0 ... T_MAX_SEC-1 in structure-of-arrays
+// layout. The samples from T_MAX_SEC on are padding: the SIMD kernels of
+// ConeCheck.c load them with the last full register, so the writers keep
+// them at 0 (see flightPathExtrapolationClearPadding), but their results
+// are never evaluated.
+// Use flightPathExtrapolationGetPathPosition to read the positions in
+// meters independent of OCAP_FIXED_POINT.
+typedef struct {
+	TFlightPathCoord x[FLIGHT_PATH_LENGTH];
+	TFlightPathCoord y[FLIGHT_PATH_LENGTH];
+	TFlightPathCoord z[FLIGHT_PATH_LENGTH];
+} TFlightPath;
+
 typedef struct {
 	// Input data.
 	TVector r0_vec;
@@ -81,5 +107,35 @@ void flightPathExtrapolationPrepareRvz(TFlightPathExtrapolationData *fpe);
 // If isCurve is 0, the flight will follow a straight line.
 void flightPathExtrapolationExecute(TFlightPathExtrapolationData *fpe);
 
+// Closed-form extrapolation.
+// Calculates position and velocity after tSec seconds directly from
+// ri_vec and vi_vec, without modifying fpe. The result for tSec = n
+// corresponds to n calls of flightPathExtrapolationExecute, without the
+// accumulation of rounding errors.
+void flightPathExtrapolationEvaluate(
+	TFlightPathExtrapolationData *fpe, float tSec, TVector *pos, TVector *vel);
+
+// Stores the positions of flightPathExtrapolationEvaluate(fpe, startSec+t)
+// in path for t = tFrom ... tTo-1 and clears the padding.
+// In fixed point, only the per-path preparation uses float.
+void flightPathExtrapolationEvaluatePath(TFlightPathExtrapolationData *fpe,
+	int32_t startSec, TFlightPath *path, int tFrom, int tTo);
+
+// Read/write the position at t of path in meters.
+void flightPathExtrapolationGetPathPosition(TFlightPath *path, int t, TVector *pos);
+void flightPathExtrapolationSetPathPosition(TFlightPath *path, int t, TVector *pos);
+
+// Sets the padding samples from T_MAX_SEC on to 0.
+void flightPathExtrapolationClearPadding(TFlightPath *path);
+
+// Subtract shift from the positions (re-base of the local frame).
+void flightPathExtrapolationShiftOrigin(TFlightPathExtrapolationData *fpe, TVector *shift);
+void flightPathExtrapolationShiftPath(TFlightPath *path, TVector *shift);
+
+// Returns 1 if the extrapolation steps for both data sets lead to exactly
+// the same positions and velocities, 0 otherwise.
+int flightPathExtrapolationEqualsParameters(
+	TFlightPathExtrapolationData *fpe1, TFlightPathExtrapolationData *fpe2);
+
 
 #endif // __FLIGHT_PATH_EXTRAPOLATION_H__
@@ -0,0 +1,91 @@
+//
+// GroundAlarmList.c
+//
+// OCAP - Open Collision Avoidance Protocol
+//
+// Alarm states of all flight objects in the ground station mode.
+//
+// 17.10.2026 ASR  First version.
+//
+// Software License (BSD):
+// Copyright 2026 Classy Code GmbH.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contribu-
+//    tors may be used to endorse or promote products derived from this soft-
+//    ware without specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS “AS IS”
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+
+#include <string.h>
+#include "GroundAlarmList.h"
+#include "AlarmStateList.h"
+
+// The lists are short, so each one is kept sorted by insertion; equal
+// priorities stay in the order of insertion.
+
+
+void groundAlarmListClear(TOcapContext *ctx)
+{
+	if (ctx->groundAlarmStateCounts) {
+		memset(ctx->groundAlarmStateCounts, 0, ctx->flightObjectCapacity * sizeof(uint8_t));
+	}
+}
+
+int groundAlarmListGetCount(TOcapContext *ctx, TFlightObjectOther *f)
+{
+	return ctx->groundAlarmStateCounts[f - ctx->flightObjects];
+}
+
+TAlarmState *groundAlarmListGetAtIndex(TOcapContext *ctx, TFlightObjectOther *f, int ix)
+{
+	int slot = (int)(f - ctx->flightObjects);
+	return &ctx->groundAlarmStates[slot * ctx->groundAlarmStateCapacity + ix];
+}
+
+TAlarmState *groundAlarmListAdd(TOcapContext *ctx, TFlightObjectOther *f,
+	TFlightObjectOther *fOther, EAlarmLevel l, int timeToEncounterSec)
+{
+	int slot = (int)(f - ctx->flightObjects);
+	TAlarmState *list = &ctx->groundAlarmStates[slot * ctx->groundAlarmStateCapacity];
+	int count = ctx->groundAlarmStateCounts[slot];
+	int newPrio = ALARM_STATE_PRIO(l, timeToEncounterSec);
+
+	// Insert after all alarm states with at least the same priority.
+	int ix = count;
+	while (ix > 0 && ALARM_STATE_PRIO(list[ix - 1].level, list[ix - 1].timeToEncounterSec) < newPrio) {
+		ix--;
+	}
+	if (ix >= ctx->groundAlarmStateCapacity) {
+		return NULL;
+	}
+	if (count < ctx->groundAlarmStateCapacity) {
+		ctx->groundAlarmStateCounts[slot] = (uint8_t)(count + 1);
+	} else {
+		// The least critical alarm state drops out.
+		count--;
+	}
+	memmove(&list[ix + 1], &list[ix], (count - ix) * sizeof(TAlarmState));
+
+	TAlarmState *a = &list[ix];
+	a->flightObject = fOther;
+	a->flightObjectHandle = fOther->handle;
+	a->level = l;
+	a->timeToEncounterSec = timeToEncounterSec;
+	return a;
+}
@@ -0,0 +1,59 @@
+//
+// GroundAlarmList.h
+//
+// OCAP - Open Collision Avoidance Protocol
+//
+// Alarm states of all flight objects in the ground station mode.
+//
+// 17.10.2026 ASR  First version.
+//
+// Software License (BSD):
+// Copyright 2026 Classy Code GmbH.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contribu-
+//    tors may be used to endorse or promote products derived from this soft-
+//    ware without specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS “AS IS”
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+
+#ifndef __GROUND_ALARM_LIST_H__
+#define __GROUND_ALARM_LIST_H__ 1
+
+#include "AlarmState.h"
+#include "FlightObjectOther.h"
+#include "OcapContext.h"
+
+// In the ground station mode (predictionCalculateAlarmStatesGround), every
+// other flight object of the context has its own list of alarm states,
+// with up to TOcapCapacities.groundAlarmStates entries. The flight object
+// of an alarm state is the one that f would be warned about.
+
+void groundAlarmListClear(TOcapContext *ctx);
+
+// Alarm states of f, by descending priority.
+int groundAlarmListGetCount(TOcapContext *ctx, TFlightObjectOther *f);
+TAlarmState *groundAlarmListGetAtIndex(TOcapContext *ctx, TFlightObjectOther *f, int ix);
+
+// Adds the alarm of f about fOther. Returns the added alarm state, or NULL
+// if the list of f is full of more critical alarm states. The pointer is
+// only valid until the next call.
+TAlarmState *groundAlarmListAdd(TOcapContext *ctx, TFlightObjectOther *f,
+	TFlightObjectOther *fOther, EAlarmLevel l, int timeToEncounterSec);
+
+#endif // __GROUND_ALARM_LIST_H__
@@ -0,0 +1,453 @@
+//
+// InputRecorder.c
+//
+// OCAP - Open Collision Avoidance Protocol
+//
+// Recording of the input of a context and its replay.
+//
+// 17.10.2026 ASR  First version.
+//
+// Software License (BSD):
+// Copyright 2026 Classy Code GmbH.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contribu-
+//    tors may be used to endorse or promote products derived from this soft-
+//    ware without specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS “AS IS”
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+
+
+#include <string.h>
+#include "InputRecorder.h"
+#include "CalculateOwnData.h"
+#include "CalculateOtherData.h"
+#include "FlightObjectList.h"
+#include "Prediction.h"
+#include "RxQueue.h"
+
+// Header: magic, version and the capacities of the context.
+#define INPUT_RECORDER_MAGIC "OCAPREC"
+#define INPUT_RECORDER_VERSION 1
+#define INPUT_RECORDER_HEADER_SIZE (8 + 6 * 4)
+
+// Record: type, length of the arguments, arguments (at most 57 bytes).
+#define INPUT_RECORDER_RECORD_SIZE_MAX 64
+
+// Flags of the received data.
+#define INPUT_RECORDER_FLAG_HAS_Z 1
+#define INPUT_RECORDER_FLAG_GLOBAL 2
+#define INPUT_RECORDER_PATH_MODEL_SHIFT 2
+
+
+// Writing and reading of the little endian arguments.
+static void inputRecorderPutU32(uint8_t *buf, int *n, uint32_t v);
+static void inputRecorderPutFloat(uint8_t *buf, int *n, float v);
+static void inputRecorderPutDouble(uint8_t *buf, int *n, double v);
+static void inputRecorderPutVector(uint8_t *buf, int *n, TVector *v);
+static void inputRecorderPutGlobalPos(uint8_t *buf, int *n, TLocalFrameGlobalPos *p);
+static uint32_t inputRecorderGetU32(const uint8_t *buf, int *n);
+static float inputRecorderGetFloat(const uint8_t *buf, int *n);
+static double inputRecorderGetDouble(const uint8_t *buf, int *n);
+static void inputRecorderGetVector(const uint8_t *buf, int *n, TVector *v);
+static void inputRecorderGetGlobalPos(const uint8_t *buf, int *n, TLocalFrameGlobalPos *p);
+
+static int inputRecorderGetArgumentSize(const uint8_t *data);
+static int inputRecorderIsRecording(TOcapContext *ctx);
+static void inputRecorderWriteRecord(TOcapContext *ctx, EInputRecordType type,
+	uint8_t *buf, int n);
+
+
+void inputRecorderStart(TOcapContext *ctx, TInputRecorderWrite write, void *user)
+{
+	uint8_t buf[INPUT_RECORDER_HEADER_SIZE];
+	memcpy(buf, INPUT_RECORDER_MAGIC, 7);
+	buf[7] = INPUT_RECORDER_VERSION;
+	int n = 8;
+	inputRecorderPutU32(buf, &n, ctx->flightObjectCapacity);
+	inputRecorderPutU32(buf, &n, ctx->alarmStateCapacity);
+	inputRecorderPutU32(buf, &n, ctx->rxQueue ? ctx->rxQueueMask + 1 : 0);
+	inputRecorderPutU32(buf, &n, ctx->alarmServiceCapacity);
+	inputRecorderPutU32(buf, &n, ctx->alarmEventQueue ? ctx->alarmEventQueueMask + 1 : 0);
+	inputRecorderPutU32(buf, &n, ctx->groundAlarmStateCapacity);
+	write(user, buf, n);
+
+	ctx->inputRecorderWrite = write;
+	ctx->inputRecorderUser = user;
+	ctx->inputRecorderSuspended = 0;
+	inputRecorderRecordPredictionInit(ctx, ctx->k, ctx->facLevel2, ctx->facLevel1);
+}
+
+void inputRecorderStop(TOcapContext *ctx)
+{
+	ctx->inputRecorderWrite = 0L;
+	ctx->inputRecorderUser = 0L;
+}
+
+int inputRecorderReadHeader(const uint8_t *data, int size, TOcapCapacities *capacities)
+{
+	if (size < INPUT_RECORDER_HEADER_SIZE || memcmp(data, INPUT_RECORDER_MAGIC, 7)
+			|| data[7] != INPUT_RECORDER_VERSION) {
+		return -1;
+	}
+	int n = 8;
+	capacities->flightObjects = (int)inputRecorderGetU32(data, &n);
+	capacities->alarmStates = (int)inputRecorderGetU32(data, &n);
+	capacities->rxQueueLength = (int)inputRecorderGetU32(data, &n);
+	capacities->alarmServiceEntries = (int)inputRecorderGetU32(data, &n);
+	capacities->alarmEventQueueLength = (int)inputRecorderGetU32(data, &n);
+	capacities->groundAlarmStates = (int)inputRecorderGetU32(data, &n);
+	// The replay predicts on the calling thread.
+	capacities->predictionThreads = 1;
+	return n;
+}
+
+int inputRecorderReplay(TOcapContext *ctx, const uint8_t *data, int size)
+{
+	if (size < 2 || size < 2 + data[1]) {
+		return -1;
+	}
+	int len = 2 + data[1];
+	if (data[1] != inputRecorderGetArgumentSize(data)) {
+		// Unknown type or corrupted.
+		return len;
+	}
+	const uint8_t *buf = data + 2;
+	int n = 0;
+	uint32_t id, ts;
+	TVector pos, vel, z;
+	TLocalFrameGlobalPos globalPos;
+	uint8_t flags;
+	EOcapPathModel pathModel;
+
+	switch (data[0]) {
+	case INPUT_RECORD_OWN:
+		ts = inputRecorderGetU32(buf, &n);
+		inputRecorderGetVector(buf, &n, &pos);
+		inputRecorderGetVector(buf, &n, &vel);
+		calculateOwnDataFromGpsInfo(ctx, ts, &pos, &vel);
+		break;
+	case INPUT_RECORD_OWN_GLOBAL:
+		ts = inputRecorderGetU32(buf, &n);
+		inputRecorderGetGlobalPos(buf, &n, &globalPos);
+		inputRecorderGetVector(buf, &n, &vel);
+		calculateOwnDataFromGlobalGpsInfo(ctx, ts, &globalPos, &vel);
+		break;
+	case INPUT_RECORD_OTHER:
+	case INPUT_RECORD_RX:
+		id = inputRecorderGetU32(buf, &n);
+		ts = inputRecorderGetU32(buf, &n);
+		flags = buf[n++];
+		pathModel = (EOcapPathModel)(flags >> INPUT_RECORDER_PATH_MODEL_SHIFT);
+		if (flags & INPUT_RECORDER_FLAG_GLOBAL) {
+			inputRecorderGetGlobalPos(buf, &n, &globalPos);
+		} else {
+			inputRecorderGetVector(buf, &n, &pos);
+		}
+		inputRecorderGetVector(buf, &n, &vel);
+		if (flags & INPUT_RECORDER_FLAG_HAS_Z) {
+			inputRecorderGetVector(buf, &n, &z);
+		}
+		if (data[0] == INPUT_RECORD_RX && (flags & INPUT_RECORDER_FLAG_GLOBAL)) {
+			// Queued again, so that the prediction applies it at the
+			// same point as in the recorded session.
+			rxQueuePushGlobal(ctx, id, ts, &globalPos, &vel,
+				flags & INPUT_RECORDER_FLAG_HAS_Z ? &z : 0L, pathModel);
+		} else if (data[0] == INPUT_RECORD_RX) {
+			rxQueuePush(ctx, id, ts, &pos, &vel,
+				flags & INPUT_RECORDER_FLAG_HAS_Z ? &z : 0L, pathModel);
+		} else {
+			TFlightObjectOther *f = flightObjectListGetOther(ctx, id);
+			if (f) {
+				calculateOtherDataFromInfo(ctx, f, ts, &pos, &vel,
+					flags & INPUT_RECORDER_FLAG_HAS_Z ? &z : 0L, pathModel);
+			}
+		}
+		break;
+	case INPUT_RECORD_ADD_OTHER:
+		flightObjectListAddOther(ctx, inputRecorderGetU32(buf, &n));
+		break;
+	case INPUT_RECORD_PREDICTION:
+		predictionCalculateAlarmStates(ctx, inputRecorderGetU32(buf, &n));
+		break;
+	case INPUT_RECORD_PREDICTION_GROUND:
+		predictionCalculateAlarmStatesGround(ctx, inputRecorderGetU32(buf, &n));
+		break;
+	case INPUT_RECORD_PREDICTION_INIT: {
+		float k = inputRecorderGetFloat(buf, &n);
+		float facLevel2 = inputRecorderGetFloat(buf, &n);
+		float facLevel1 = inputRecorderGetFloat(buf, &n);
+		predictionInit(ctx, k, facLevel2, facLevel1);
+		break;
+	}
+	case INPUT_RECORD_LIST_INIT:
+		flightObjectListInit(ctx, inputRecorderGetU32(buf, &n));
+		break;
+	default:
+		break;
+	}
+	return len;
+}
+
+void inputRecorderRecordOwn(TOcapContext *ctx, uint32_t ts,
+	TVector *curPos, TVector *curVel)
+{
+	if (!inputRecorderIsRecording(ctx)) {
+		return;
+	}
+	uint8_t buf[INPUT_RECORDER_RECORD_SIZE_MAX];
+	int n = 2;
+	inputRecorderPutU32(buf, &n, ts);
+	inputRecorderPutVector(buf, &n, curPos);
+	inputRecorderPutVector(buf, &n, curVel);
+	inputRecorderWriteRecord(ctx, INPUT_RECORD_OWN, buf, n);
+}
+
+void inputRecorderRecordOwnGlobal(TOcapContext *ctx, uint32_t ts,
+	TLocalFrameGlobalPos *curPos, TVector *curVel)
+{
+	if (!inputRecorderIsRecording(ctx)) {
+		return;
+	}
+	uint8_t buf[INPUT_RECORDER_RECORD_SIZE_MAX];
+	int n = 2;
+	inputRecorderPutU32(buf, &n, ts);
+	inputRecorderPutGlobalPos(buf, &n, curPos);
+	inputRecorderPutVector(buf, &n, curVel);
+	inputRecorderWriteRecord(ctx, INPUT_RECORD_OWN_GLOBAL, buf, n);
+}
+
+void inputRecorderRecordOther(TOcapContext *ctx, TFlightObjectOther *f, uint32_t ts,
+	TVector *curPos, TVector *curVel, TVector *z, EOcapPathModel pathModel)
+{
+	if (!inputRecorderIsRecording(ctx)) {
+		return;
+	}
+	uint8_t buf[INPUT_RECORDER_RECORD_SIZE_MAX];
+	int n = 2;
+	inputRecorderPutU32(buf, &n, f->id);
+	inputRecorderPutU32(buf, &n, ts);
+	buf[n++] = (z ? INPUT_RECORDER_FLAG_HAS_Z : 0)
+		| (uint8_t)(pathModel << INPUT_RECORDER_PATH_MODEL_SHIFT);
+	inputRecorderPutVector(buf, &n, curPos);
+	inputRecorderPutVector(buf, &n, curVel);
+	if (z) {
+		inputRecorderPutVector(buf, &n, z);
+	}
+	inputRecorderWriteRecord(ctx, INPUT_RECORD_OTHER, buf, n);
+}
+
+void inputRecorderRecordAddOther(TOcapContext *ctx, uint32_t id)
+{
+	if (!inputRecorderIsRecording(ctx)) {
+		return;
+	}
+	uint8_t buf[INPUT_RECORDER_RECORD_SIZE_MAX];
+	int n = 2;
+	inputRecorderPutU32(buf, &n, id);
+	inputRecorderWriteRecord(ctx, INPUT_RECORD_ADD_OTHER, buf, n);
+}
+
+void inputRecorderRecordRx(TOcapContext *ctx, TRxQueueEntry *e)
+{
+	if (!inputRecorderIsRecording(ctx)) {
+		return;
+	}
+	uint8_t buf[INPUT_RECORDER_RECORD_SIZE_MAX];
+	int n = 2;
+	inputRecorderPutU32(buf, &n, e->id);
+	inputRecorderPutU32(buf, &n, e->ts);
+	buf[n++] = (e->hasZ ? INPUT_RECORDER_FLAG_HAS_Z : 0)
+		| (e->isGlobal ? INPUT_RECORDER_FLAG_GLOBAL : 0)
+		| (uint8_t)(e->pathModel << INPUT_RECORDER_PATH_MODEL_SHIFT);
+	if (e->isGlobal) {
+		inputRecorderPutGlobalPos(buf, &n, &e->pos);
+	} else {
+		// Pushed as float (rxQueuePush).
+		TVector pos;
+		vectorInit(&pos, (float)e->pos.x, (float)e->pos.y, (float)e->pos.z);
+		inputRecorderPutVector(buf, &n, &pos);
+	}
+	inputRecorderPutVector(buf, &n, &e->vel);
+	if (e->hasZ) {
+		inputRecorderPutVector(buf, &n, &e->z);
+	}
+	inputRecorderWriteRecord(ctx, INPUT_RECORD_RX, buf, n);
+}
+
+void inputRecorderRecordPrediction(TOcapContext *ctx, EInputRecordType type, uint32_t ts)
+{
+	if (!inputRecorderIsRecording(ctx)) {
+		return;
+	}
+	uint8_t buf[INPUT_RECORDER_RECORD_SIZE_MAX];
+	int n = 2;
+	inputRecorderPutU32(buf, &n, ts);
+	inputRecorderWriteRecord(ctx, type, buf, n);
+}
+
+void inputRecorderRecordPredictionInit(TOcapContext *ctx,
+	float k, float facLevel2, float facLevel1)
+{
+	if (!inputRecorderIsRecording(ctx)) {
+		return;
+	}
+	uint8_t buf[INPUT_RECORDER_RECORD_SIZE_MAX];
+	int n = 2;
+	inputRecorderPutFloat(buf, &n, k);
+	inputRecorderPutFloat(buf, &n, facLevel2);
+	inputRecorderPutFloat(buf, &n, facLevel1);
+	inputRecorderWriteRecord(ctx, INPUT_RECORD_PREDICTION_INIT, buf, n);
+}
+
+void inputRecorderRecordListInit(TOcapContext *ctx, uint32_t idOwn)
+{
+	if (!inputRecorderIsRecording(ctx)) {
+		return;
+	}
+	uint8_t buf[INPUT_RECORDER_RECORD_SIZE_MAX];
+	int n = 2;
+	inputRecorderPutU32(buf, &n, idOwn);
+	inputRecorderWriteRecord(ctx, INPUT_RECORD_LIST_INIT, buf, n);
+}
+
+// Returns the size of the arguments of the record at data (its length
+// byte is valid), or -1 if the type or the flags are invalid.
+static int inputRecorderGetArgumentSize(const uint8_t *data)
+{
+	switch (data[0]) {
+	case INPUT_RECORD_OWN:
+		return 4 + 2 * 12;
+	case INPUT_RECORD_OWN_GLOBAL:
+		return 4 + 24 + 12;
+	case INPUT_RECORD_OTHER:
+	case INPUT_RECORD_RX: {
+		if (data[1] < 9) {
+			return -1;
+		}
+		uint8_t flags = data[2 + 8];
+		if (data[0] == INPUT_RECORD_OTHER && (flags & INPUT_RECORDER_FLAG_GLOBAL)) {
+			return -1;
+		}
+		return 9 + (flags & INPUT_RECORDER_FLAG_GLOBAL ? 24 : 12) + 12
+			+ (flags & INPUT_RECORDER_FLAG_HAS_Z ? 12 : 0);
+	}
+	case INPUT_RECORD_ADD_OTHER:
+	case INPUT_RECORD_PREDICTION:
+	case INPUT_RECORD_PREDICTION_GROUND:
+	case INPUT_RECORD_LIST_INIT:
+		return 4;
+	case INPUT_RECORD_PREDICTION_INIT:
+		return 3 * 4;
+	default:
+		return -1;
+	}
+}
+
+static int inputRecorderIsRecording(TOcapContext *ctx)
+{
+	return ctx->inputRecorderWrite && !ctx->inputRecorderSuspended;
+}
+
+// Writes the record in buf (n bytes, the arguments start at buf[2]).
+static void inputRecorderWriteRecord(TOcapContext *ctx, EInputRecordType type,
+	uint8_t *buf, int n)
+{
+	buf[0] = (uint8_t)type;
+	buf[1] = (uint8_t)(n - 2);
+	ctx->inputRecorderWrite(ctx->inputRecorderUser, buf, n);
+}
+
+static void inputRecorderPutU32(uint8_t *buf, int *n, uint32_t v)
+{
+	buf[*n] = (uint8_t)v;
+	buf[*n + 1] = (uint8_t)(v >> 8);
+	buf[*n + 2] = (uint8_t)(v >> 16);
+	buf[*n + 3] = (uint8_t)(v >> 24);
+	*n += 4;
+}
+
+static void inputRecorderPutFloat(uint8_t *buf, int *n, float v)
+{
+	uint32_t u;
+	memcpy(&u, &v, 4);
+	inputRecorderPutU32(buf, n, u);
+}
+
+static void inputRecorderPutDouble(uint8_t *buf, int *n, double v)
+{
+	uint64_t u;
+	memcpy(&u, &v, 8);
+	inputRecorderPutU32(buf, n, (uint32_t)u);
+	inputRecorderPutU32(buf, n, (uint32_t)(u >> 32));
+}
+
+static void inputRecorderPutVector(uint8_t *buf, int *n, TVector *v)
+{
+	inputRecorderPutFloat(buf, n, v->x);
+	inputRecorderPutFloat(buf, n, v->y);
+	inputRecorderPutFloat(buf, n, v->z);
+}
+
+static void inputRecorderPutGlobalPos(uint8_t *buf, int *n, TLocalFrameGlobalPos *p)
+{
+	inputRecorderPutDouble(buf, n, p->x);
+	inputRecorderPutDouble(buf, n, p->y);
+	inputRecorderPutDouble(buf, n, p->z);
+}
+
+static uint32_t inputRecorderGetU32(const uint8_t *buf, int *n)
+{
+	uint32_t v = (uint32_t)buf[*n]
+		| ((uint32_t)buf[*n + 1] << 8)
+		| ((uint32_t)buf[*n + 2] << 16)
+		| ((uint32_t)buf[*n + 3] << 24);
+	*n += 4;
+	return v;
+}
+
+static float inputRecorderGetFloat(const uint8_t *buf, int *n)
+{
+	uint32_t u = inputRecorderGetU32(buf, n);
+	float v;
+	memcpy(&v, &u, 4);
+	return v;
+}
+
+static double inputRecorderGetDouble(const uint8_t *buf, int *n)
+{
+	uint64_t u = inputRecorderGetU32(buf, n);
+	u |= (uint64_t)inputRecorderGetU32(buf, n) << 32;
+	double v;
+	memcpy(&v, &u, 8);
+	return v;
+}
+
+static void inputRecorderGetVector(const uint8_t *buf, int *n, TVector *v)
+{
+	v->x = inputRecorderGetFloat(buf, n);
+	v->y = inputRecorderGetFloat(buf, n);
+	v->z = inputRecorderGetFloat(buf, n);
+}
+
+static void inputRecorderGetGlobalPos(const uint8_t *buf, int *n, TLocalFrameGlobalPos *p)
+{
+	p->x = inputRecorderGetDouble(buf, n);
+	p->y = inputRecorderGetDouble(buf, n);
+	p->z = inputRecorderGetDouble(buf, n);
+}
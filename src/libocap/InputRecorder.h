@@ -0,0 +1,103 @@
+//
+// InputRecorder.h
+//
+// OCAP - Open Collision Avoidance Protocol
+//
+// Recording of the input of a context and its replay.
+//
+// 17.10.2026 ASR  First version.
+//
+// Software License (BSD):
+// Copyright 2026 Classy Code GmbH.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contribu-
+//    tors may be used to endorse or promote products derived from this soft-
+//    ware without specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS “AS IS”
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+
+
+#ifndef __INPUT_RECORDER_H__
+#define __INPUT_RECORDER_H__ 1
+
+#include <inttypes.h>
+#include "Vector.h"
+#include "FlightObjectOther.h"
+#include "FlightPathExtrapolation.h"
+#include "LocalFrame.h"
+#include "OcapContext.h"
+
+// The recorder writes all input of a context into an append-only binary
+// log: our own positions, the received data, the added flight objects and
+// the predictions, with their arguments and timestamps. The updates of the
+// receive queue (RxQueue.h) are recorded when the prediction applies them.
+// The log starts with a header (the capacities of the context), followed by
+// records of a type byte, a length byte and the little endian arguments.
+// Replaying the log on a new context with the same capacities reproduces
+// the alarm states of the recorded session.
+// The library doesn't do any I/O: the recorded bytes go to a sink of the
+// application (e.g. a file or flash memory). The sink is called on the
+// thread of the prediction.
+
+// Types of the records.
+typedef enum {
+	INPUT_RECORD_OWN = 1,              // calculateOwnDataFromGpsInfo
+	INPUT_RECORD_OWN_GLOBAL = 2,       // calculateOwnDataFromGlobalGpsInfo
+	INPUT_RECORD_OTHER = 3,            // calculateOtherDataFromInfo
+	INPUT_RECORD_ADD_OTHER = 4,        // flightObjectListAddOther
+	INPUT_RECORD_RX = 5,               // update applied by rxQueueDrain
+	INPUT_RECORD_PREDICTION = 6,       // predictionCalculateAlarmStates
+	INPUT_RECORD_PREDICTION_GROUND = 7,// predictionCalculateAlarmStatesGround
+	INPUT_RECORD_PREDICTION_INIT = 8,  // predictionInit
+	INPUT_RECORD_LIST_INIT = 9         // flightObjectListInit
+} EInputRecordType;
+
+// Starts recording the input of ctx into the sink; writes the header and
+// the current prediction parameters. Start the recording right after
+// ocapContextInitWithMemory, as the replay starts with a new context.
+void inputRecorderStart(TOcapContext *ctx, TInputRecorderWrite write, void *user);
+
+void inputRecorderStop(TOcapContext *ctx);
+
+// Reads the header at the start of a recording: fills in the capacities of
+// the recorded context and returns the size of the header, or -1 if data
+// isn't a recording of this version.
+int inputRecorderReadHeader(const uint8_t *data, int size, TOcapCapacities *capacities);
+
+// Replays the record at data on ctx (initialized with the capacities of
+// the header). Returns the size of the record, or -1 if it is incomplete.
+// Records of an unknown type or with invalid arguments are skipped.
+int inputRecorderReplay(TOcapContext *ctx, const uint8_t *data, int size);
+
+// Called by the recorded methods (only records if recording and not
+// within another recorded method).
+void inputRecorderRecordOwn(TOcapContext *ctx, uint32_t ts,
+	TVector *curPos, TVector *curVel);
+void inputRecorderRecordOwnGlobal(TOcapContext *ctx, uint32_t ts,
+	TLocalFrameGlobalPos *curPos, TVector *curVel);
+void inputRecorderRecordOther(TOcapContext *ctx, TFlightObjectOther *f, uint32_t ts,
+	TVector *curPos, TVector *curVel, TVector *z, EOcapPathModel pathModel);
+void inputRecorderRecordAddOther(TOcapContext *ctx, uint32_t id);
+void inputRecorderRecordRx(TOcapContext *ctx, TRxQueueEntry *e);
+void inputRecorderRecordPrediction(TOcapContext *ctx, EInputRecordType type, uint32_t ts);
+void inputRecorderRecordPredictionInit(TOcapContext *ctx,
+	float k, float facLevel2, float facLevel1);
+void inputRecorderRecordListInit(TOcapContext *ctx, uint32_t idOwn);
+
+#endif // __INPUT_RECORDER_H__
@@ -0,0 +1,118 @@
+//
+// LocalFrame.c
+//
+// OCAP - Open Collision Avoidance Protocol
+//
+// Local coordinate frame with a movable origin near our own position.
+//
+// 17.10.2026 ASR  First version.
+//
+// Software License (BSD):
+// Copyright 2026 Classy Code GmbH.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contribu-
+//    tors may be used to endorse or promote products derived from this soft-
+//    ware without specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS “AS IS”
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+
+#include <math.h>
+#include "LocalFrame.h"
+
+
+static int16_t localFrameQuantizeCoord(float v, int *inRange);
+
+
+void localFrameInit(TLocalFrame *frame)
+{
+	frame->origin.x = 0;
+	frame->origin.y = 0;
+	frame->origin.z = 0;
+}
+
+void localFrameToLocal(TLocalFrame *frame, TLocalFrameGlobalPos *global, TVector *local)
+{
+	// The difference is calculated in double, only the (small) result is
+	// rounded to float.
+	local->x = (float)(global->x - frame->origin.x);
+	local->y = (float)(global->y - frame->origin.y);
+	local->z = (float)(global->z - frame->origin.z);
+}
+
+void localFrameToGlobal(TLocalFrame *frame, TVector *local, TLocalFrameGlobalPos *global)
+{
+	global->x = frame->origin.x + local->x;
+	global->y = frame->origin.y + local->y;
+	global->z = frame->origin.z + local->z;
+}
+
+int localFrameRebase(TLocalFrame *frame, TLocalFrameGlobalPos *ownGlobal, TVector *shift)
+{
+	double dx = ownGlobal->x - frame->origin.x;
+	double dy = ownGlobal->y - frame->origin.y;
+	if (fabs(dx) <= LOCAL_FRAME_REBASE_MTR && fabs(dy) <= LOCAL_FRAME_REBASE_MTR) {
+		return 0;
+	}
+
+	// The altitude stays in the frame: it is small anyway.
+	TLocalFrameGlobalPos origin;
+	origin.x = floor(ownGlobal->x + 0.5);
+	origin.y = floor(ownGlobal->y + 0.5);
+	origin.z = frame->origin.z;
+
+	// Whole meters: exact in float up to 2^24m.
+	vectorInit(shift,
+		(float)(origin.x - frame->origin.x),
+		(float)(origin.y - frame->origin.y),
+		0);
+	frame->origin = origin;
+	return 1;
+}
+
+int localFrameQuantize(TVector *local, TLocalFrameQuantizedPos *q)
+{
+	int inRange = 1;
+	q->x = localFrameQuantizeCoord(local->x, &inRange);
+	q->y = localFrameQuantizeCoord(local->y, &inRange);
+	q->z = localFrameQuantizeCoord(local->z, &inRange);
+	return inRange;
+}
+
+void localFrameDequantize(TLocalFrameQuantizedPos *q, TVector *local)
+{
+	local->x = q->x * LOCAL_FRAME_QUANTUM_MTR;
+	local->y = q->y * LOCAL_FRAME_QUANTUM_MTR;
+	local->z = q->z * LOCAL_FRAME_QUANTUM_MTR;
+}
+
+// Rounds v to the nearest multiple of LOCAL_FRAME_QUANTUM_MTR, saturated
+// to the int16 range. Clears inRange if saturated.
+static int16_t localFrameQuantizeCoord(float v, int *inRange)
+{
+	float q = floorf(v / LOCAL_FRAME_QUANTUM_MTR + 0.5f);
+	if (q > INT16_MAX) {
+		*inRange = 0;
+		return INT16_MAX;
+	}
+	if (q < INT16_MIN) {
+		*inRange = 0;
+		return INT16_MIN;
+	}
+	return (int16_t)q;
+}
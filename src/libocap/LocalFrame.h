@@ -0,0 +1,85 @@
+//
+// LocalFrame.h
+//
+// OCAP - Open Collision Avoidance Protocol
+//
+// Local coordinate frame with a movable origin near our own position.
+//
+// 17.10.2026 ASR  First version.
+//
+// Software License (BSD):
+// Copyright 2026 Classy Code GmbH.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contribu-
+//    tors may be used to endorse or promote products derived from this soft-
+//    ware without specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS “AS IS”
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+
+#ifndef __LOCAL_FRAME_H__
+#define __LOCAL_FRAME_H__ 1
+
+#include <inttypes.h>
+#include "Configuration.h"
+#include "Vector.h"
+
+// Global coordinates are meters from the equator and the prime meridian,
+// about 5e6m in central Europe, where the resolution of float is 0.5m.
+// The library stores the positions relative to the origin of the local
+// frame instead, so that they stay within a few 10km (resolution 2mm).
+// The origin is on a whole meter, so that a re-base is an exact shift.
+
+// Position in global coordinates [m].
+typedef struct {
+	double x;
+	double y;
+	double z;
+} TLocalFrameGlobalPos;
+
+// Quantized position in the local frame, in LOCAL_FRAME_QUANTUM_MTR.
+typedef struct {
+	int16_t x;
+	int16_t y;
+	int16_t z;
+} TLocalFrameQuantizedPos;
+
+typedef struct {
+	// Origin in global coordinates [m].
+	TLocalFrameGlobalPos origin;
+} TLocalFrame;
+
+
+// Sets the origin to the global origin (local = global coordinates).
+void localFrameInit(TLocalFrame *frame);
+
+void localFrameToLocal(TLocalFrame *frame, TLocalFrameGlobalPos *global, TVector *local);
+void localFrameToGlobal(TLocalFrame *frame, TVector *local, TLocalFrameGlobalPos *global);
+
+// Returns 1 and moves the origin to ownGlobal if our own position is more
+// than LOCAL_FRAME_REBASE_MTR away from the origin (horizontally), 0
+// otherwise. shift is the movement of the origin: subtract it from all
+// positions stored in the old frame.
+int localFrameRebase(TLocalFrame *frame, TLocalFrameGlobalPos *ownGlobal, TVector *shift);
+
+// Quantization of local positions to 16 bits, for compact storage of flight
+// paths. Returns 0 if a coordinate is out of range (it is saturated).
+int localFrameQuantize(TVector *local, TLocalFrameQuantizedPos *q);
+void localFrameDequantize(TLocalFrameQuantizedPos *q, TVector *local);
+
+#endif // __LOCAL_FRAME_H__
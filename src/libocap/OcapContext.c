@@ -0,0 +1,272 @@
+//
+// OcapContext.c
+//
+// OCAP - Open Collision Avoidance Protocol
+//
+// State of one library instance (own aircraft, surrounding aircraft,
+// alarm states and prediction data).
+//
+// 17.10.2026 ASR  First version.
+//
+// Software License (BSD):
+// Copyright 2026 Classy Code GmbH.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contribu-
+//    tors may be used to endorse or promote products derived from this soft-
+//    ware without specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS “AS IS”
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+
+#include <string.h>
+#include "OcapContext.h"
+#include "AlarmStateList.h"
+#include "FlightObjectList.h"
+#include "RxQueue.h"
+#include "AlarmEventQueue.h"
+#include "Prediction.h"
+
+// Alignment of the tables in the context memory.
+#define OCAP_CONTEXT_MEMORY_ALIGN 16
+
+static size_t ocapContextLayout(
+	TOcapContext *ctx, const TOcapCapacities *capacities, uint8_t *base);
+
+static void *ocapContextAllocate(uint8_t *base, size_t *offset, size_t size);
+
+
+void ocapCapacitiesInitDefault(TOcapCapacities *capacities)
+{
+	capacities->flightObjects = FLIGHT_OBJECT_LIST_LENGTH;
+	capacities->alarmStates = ALARM_STATE_LIST_LENGTH;
+	capacities->rxQueueLength = RX_QUEUE_LENGTH;
+	capacities->alarmServiceEntries = ALARM_SERVICE_LIST_LENGTH;
+	capacities->alarmEventQueueLength = ALARM_EVENT_QUEUE_LENGTH;
+	capacities->groundAlarmStates = 0;
+	capacities->predictionThreads = 1;
+}
+
+size_t ocapContextGetMemorySize(const TOcapCapacities *capacities)
+{
+	if (capacities->flightObjects < 1
+			|| capacities->flightObjects > OCAP_CAPACITY_FLIGHT_OBJECTS_MAX
+			|| capacities->alarmStates < 1
+			|| capacities->alarmStates > OCAP_CAPACITY_ALARM_STATES_MAX
+			|| capacities->rxQueueLength < 0
+			|| capacities->rxQueueLength > RX_QUEUE_LENGTH_MAX
+			|| capacities->alarmServiceEntries < 0
+			|| capacities->alarmServiceEntries > OCAP_CAPACITY_ALARM_SERVICE_ENTRIES_MAX
+			|| capacities->alarmEventQueueLength < 0
+			|| capacities->alarmEventQueueLength > ALARM_EVENT_QUEUE_LENGTH_MAX
+			|| capacities->groundAlarmStates < 0
+			|| capacities->groundAlarmStates > OCAP_CAPACITY_GROUND_ALARM_STATES_MAX
+			|| capacities->predictionThreads < 1
+			|| capacities->predictionThreads > PREDICTION_THREADS_MAX) {
+		return 0;
+	}
+	// Including the alignment of mem.
+	return ocapContextLayout(0L, capacities, 0L) + OCAP_CONTEXT_MEMORY_ALIGN - 1;
+}
+
+int ocapContextInitWithMemory(TOcapContext *ctx,
+	const TOcapCapacities *capacities, void *mem, size_t memSize)
+{
+	size_t size = ocapContextGetMemorySize(capacities);
+	if (size == 0 || memSize < size) {
+		return -1;
+	}
+
+	memset(ctx, 0, sizeof(TOcapContext));
+	memset(mem, 0, size);
+
+	uintptr_t base = ((uintptr_t)mem + OCAP_CONTEXT_MEMORY_ALIGN - 1)
+		/ OCAP_CONTEXT_MEMORY_ALIGN * OCAP_CONTEXT_MEMORY_ALIGN;
+	ocapContextLayout(ctx, capacities, (uint8_t *)base);
+
+	localFrameInit(&ctx->localFrame);
+
+	// Default prediction parameters, see predictionInit.
+	ctx->k = 30;
+	ctx->facLevel2 = 2;
+	ctx->facLevel1 = 3;
+	// Valid handles from the start; the own ID is set by a later
+	// flightObjectListInit.
+	flightObjectListInit(ctx, 0);
+	alarmStateListClear(ctx);
+	rxQueueInit(ctx);
+	alarmEventQueueInit(ctx);
+#if PREDICTION_THREADS_MAX > 1
+	predictionStartThreads(ctx, capacities->predictionThreads);
+#endif
+	return 0;
+}
+
+void ocapContextExit(TOcapContext *ctx)
+{
+#if PREDICTION_THREADS_MAX > 1
+	predictionStopThreads(ctx);
+#else
+	(void)ctx;
+#endif
+}
+
+// Places the tables of ctx in the memory at base and returns the number
+// of bytes used. Only calculates the size if base is 0.
+static size_t ocapContextLayout(
+	TOcapContext *ctx, const TOcapCapacities *capacities, uint8_t *base)
+{
+	size_t offset = 0;
+	int n = capacities->flightObjects;
+
+	TFlightObjectOther *flightObjects = (TFlightObjectOther *)
+		ocapContextAllocate(base, &offset, n * sizeof(TFlightObjectOther));
+	uint16_t *flightObjectFreeNext = (uint16_t *)
+		ocapContextAllocate(base, &offset, n * sizeof(uint16_t));
+#if FLIGHT_OBJECT_OTHER_PATH_CACHE == 1
+	TFlightPathCache *pathCaches = (TFlightPathCache *)
+		ocapContextAllocate(base, &offset, n * sizeof(TFlightPathCache));
+#endif
+#if FLIGHT_OBJECT_LIST_ID_INDEX == 1
+	int indexLength = 1;
+	while (indexLength < 2 * n) {
+		indexLength *= 2;
+	}
+	uint16_t *flightObjectIndex = (uint16_t *)
+		ocapContextAllocate(base, &offset, indexLength * sizeof(uint16_t));
+#endif
+#if FLIGHT_OBJECT_LIST_GRID == 1
+	uint16_t *gridNext = (uint16_t *)
+		ocapContextAllocate(base, &offset, n * sizeof(uint16_t));
+	int16_t *gridBucket = (int16_t *)
+		ocapContextAllocate(base, &offset, n * sizeof(int16_t));
+	int32_t *gridCellX = (int32_t *)
+		ocapContextAllocate(base, &offset, n * sizeof(int32_t));
+	int32_t *gridCellY = (int32_t *)
+		ocapContextAllocate(base, &offset, n * sizeof(int32_t));
+	uint32_t *gridSelected = (uint32_t *)
+		ocapContextAllocate(base, &offset, (n + 31) / 32 * sizeof(uint32_t));
+#endif
+	int k = capacities->alarmStates;
+	TAlarmState *alarmStates = (TAlarmState *)ocapContextAllocate(
+		base, &offset, k * sizeof(TAlarmState));
+	uint32_t *alarmStateSeq = (uint32_t *)ocapContextAllocate(
+		base, &offset, k * sizeof(uint32_t));
+	int *alarmStateHeapPos = (int *)ocapContextAllocate(
+		base, &offset, k * sizeof(int));
+	int *alarmStateHeap = (int *)ocapContextAllocate(
+		base, &offset, k * sizeof(int));
+	int *alarmStateOrder = (int *)ocapContextAllocate(
+		base, &offset, k * sizeof(int));
+	int alarmIndexLength = 1;
+	while (alarmIndexLength < 2 * k) {
+		alarmIndexLength *= 2;
+	}
+	uint16_t *alarmStateIndex = (uint16_t *)ocapContextAllocate(
+		base, &offset, alarmIndexLength * sizeof(uint16_t));
+	int rxQueueLength = 0;
+	while (rxQueueLength < capacities->rxQueueLength) {
+		rxQueueLength = rxQueueLength ? 2 * rxQueueLength : 1;
+	}
+	TRxQueueEntry *rxQueue = (TRxQueueEntry *)
+		ocapContextAllocate(base, &offset, rxQueueLength * sizeof(TRxQueueEntry));
+#if PREDICTION_THREADS_MAX > 1
+	TPredictionResult *predictionResults = (TPredictionResult *)
+		ocapContextAllocate(base, &offset, n * sizeof(TPredictionResult));
+#endif
+	int m = capacities->alarmServiceEntries;
+	TAlarmServiceEntry *alarmServiceEntries = (TAlarmServiceEntry *)
+		ocapContextAllocate(base, &offset, m * sizeof(TAlarmServiceEntry));
+	uint16_t *alarmServiceSlotEntry = (uint16_t *)
+		ocapContextAllocate(base, &offset, (m ? n : 0) * sizeof(uint16_t));
+	int alarmEventQueueLength = 0;
+	while (alarmEventQueueLength < capacities->alarmEventQueueLength) {
+		alarmEventQueueLength = alarmEventQueueLength ? 2 * alarmEventQueueLength : 1;
+	}
+	int nEvent = alarmEventQueueLength ? n : 0;
+	TAlarmEvent *alarmEventQueue = (TAlarmEvent *)ocapContextAllocate(
+		base, &offset, alarmEventQueueLength * sizeof(TAlarmEvent));
+	TAlarmEventSlot *alarmEventSlots = (TAlarmEventSlot *)ocapContextAllocate(
+		base, &offset, nEvent * sizeof(TAlarmEventSlot));
+	uint16_t *alarmEventActiveSlots = (uint16_t *)ocapContextAllocate(
+		base, &offset, nEvent * sizeof(uint16_t));
+	int g = capacities->groundAlarmStates;
+	int nGround = g ? n : 0;
+	TGroundFlightPath *groundFlightPaths = (TGroundFlightPath *)ocapContextAllocate(
+		base, &offset, nGround * sizeof(TGroundFlightPath));
+	TAlarmState *groundAlarmStates = (TAlarmState *)ocapContextAllocate(
+		base, &offset, nGround * g * sizeof(TAlarmState));
+	uint8_t *groundAlarmStateCounts = (uint8_t *)ocapContextAllocate(
+		base, &offset, nGround * sizeof(uint8_t));
+
+	if (!ctx) {
+		return offset;
+	}
+
+	ctx->flightObjects = flightObjects;
+	ctx->flightObjectCapacity = n;
+	ctx->flightObjectFreeNext = flightObjectFreeNext;
+#if FLIGHT_OBJECT_OTHER_PATH_CACHE == 1
+	ctx->flightObjectPathCaches = pathCaches;
+#endif
+#if FLIGHT_OBJECT_LIST_ID_INDEX == 1
+	ctx->flightObjectIndex = flightObjectIndex;
+	ctx->flightObjectIndexMask = indexLength - 1;
+#endif
+#if FLIGHT_OBJECT_LIST_GRID == 1
+	ctx->flightObjectGridNext = gridNext;
+	ctx->flightObjectGridBucket = gridBucket;
+	ctx->flightObjectGridCellX = gridCellX;
+	ctx->flightObjectGridCellY = gridCellY;
+	ctx->flightObjectGridSelected = gridSelected;
+#endif
+	ctx->alarmStates = alarmStates;
+	ctx->alarmStateCapacity = k;
+	ctx->alarmStateSeq = alarmStateSeq;
+	ctx->alarmStateHeapPos = alarmStateHeapPos;
+	ctx->alarmStateHeap = alarmStateHeap;
+	ctx->alarmStateOrder = alarmStateOrder;
+	ctx->alarmStateIndex = alarmStateIndex;
+	ctx->alarmStateIndexMask = alarmIndexLength - 1;
+	ctx->rxQueue = rxQueueLength ? rxQueue : 0L;
+	ctx->rxQueueMask = rxQueueLength ? rxQueueLength - 1 : 0;
+#if PREDICTION_THREADS_MAX > 1
+	ctx->predictionResults = predictionResults;
+#endif
+	ctx->alarmServiceEntries = m ? alarmServiceEntries : 0L;
+	ctx->alarmServiceCapacity = m;
+	ctx->alarmServiceSlotEntry = m ? alarmServiceSlotEntry : 0L;
+	ctx->alarmEventQueue = alarmEventQueueLength ? alarmEventQueue : 0L;
+	ctx->alarmEventQueueMask = alarmEventQueueLength ? alarmEventQueueLength - 1 : 0;
+	ctx->alarmEventSlots = alarmEventQueueLength ? alarmEventSlots : 0L;
+	ctx->alarmEventActiveSlots = alarmEventQueueLength ? alarmEventActiveSlots : 0L;
+	ctx->groundFlightPaths = g ? groundFlightPaths : 0L;
+	ctx->groundAlarmStates = g ? groundAlarmStates : 0L;
+	ctx->groundAlarmStateCounts = g ? groundAlarmStateCounts : 0L;
+	ctx->groundAlarmStateCapacity = g;
+	return offset;
+}
+
+// Reserves size bytes at *offset (aligned) and returns their address,
+// or 0 if base is 0.
+static void *ocapContextAllocate(uint8_t *base, size_t *offset, size_t size)
+{
+	size_t start = (*offset + OCAP_CONTEXT_MEMORY_ALIGN - 1)
+		/ OCAP_CONTEXT_MEMORY_ALIGN * OCAP_CONTEXT_MEMORY_ALIGN;
+	*offset = start + size;
+	return base ? base + start : 0L;
+}
@@ -0,0 +1,390 @@
+//
+// OcapContext.h
+//
+// OCAP - Open Collision Avoidance Protocol
+//
+// State of one library instance (own aircraft, surrounding aircraft,
+// alarm states and prediction data).
+//
+// 17.10.2026 ASR  First version.
+//
+// Software License (BSD):
+// Copyright 2026 Classy Code GmbH.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contribu-
+//    tors may be used to endorse or promote products derived from this soft-
+//    ware without specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS “AS IS”
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+
+#ifndef __OCAP_CONTEXT_H__
+#define __OCAP_CONTEXT_H__ 1
+
+#include <inttypes.h>
+#include <stddef.h>
+#include "Configuration.h"
+#if PREDICTION_THREADS_MAX > 1
+#include <pthread.h>
+#endif
+#include "Vector.h"
+#include "AlarmState.h"
+#include "FlightObjectOwn.h"
+#include "FlightObjectOther.h"
+#include "FlightPathExtrapolation.h"
+#include "ConeCheck.h"
+#include "LocalFrame.h"
+
+// The alarm service stretches the alarm level (low=1, high=3) internally by
+// this factor, so that it can apply a fine-grained decay.
+#define ALARM_SERVICE_FACTOR 4
+
+// Filtered alarm information, see AlarmService.h.
+typedef struct {
+	TFlightObjectOther *flightObject;
+	TFlightObjectHandle flightObjectHandle;
+	int level;
+	int distMtr;
+	int timeToEncounterSec;
+	int approaching;
+	// Set if the entry got an alarm state in the current alarmServiceUpdate.
+	int isUpdated;
+	// Flight object slot + 1 of the next entry with the same level, see
+	// alarmServiceLevelFirst (0 if none).
+	uint16_t nextOfLevel;
+} TAlarmServiceEntry;
+
+// Received update of an other flight object, see RxQueue.h.
+typedef struct {
+	// Sequence number of the entry (see RxQueue.c).
+	uint32_t seq;
+	uint32_t id;
+	uint32_t ts;
+	// Position in global (1) or local (0) coordinates.
+	int isGlobal;
+	TLocalFrameGlobalPos pos;
+	TVector vel;
+	int hasZ;
+	TVector z;
+	EOcapPathModel pathModel;
+} TRxQueueEntry;
+
+// Type of an alarm event, see AlarmEventQueue.h.
+typedef enum {
+	// A flight object without alarm has got an alarm.
+	ALARM_EVENT_RAISED = 1,
+	// The alarm level of a flight object has increased or decreased.
+	ALARM_EVENT_ESCALATED = 2,
+	ALARM_EVENT_DEESCALATED = 3,
+	// The alarm of a flight object has ended (or it has been released).
+	ALARM_EVENT_CLEARED = 4
+} EAlarmEventType;
+
+// Change of the alarm of one flight object, see AlarmEventQueue.h.
+typedef struct {
+	EAlarmEventType type;
+	// Timestamp of the prediction.
+	uint32_t ts;
+	uint32_t id;
+	TFlightObjectHandle flightObjectHandle;
+	// New alarm level (ALARM_LEVEL_NONE if cleared) and the one before.
+	EAlarmLevel level;
+	EAlarmLevel previousLevel;
+	// -1 if not available.
+	int timeToEncounterSec;
+	int distMtr;
+} TAlarmEvent;
+
+// Alarm level of a flight object slot as reported by the last alarm
+// events, see AlarmEventQueue.c.
+typedef struct {
+	TFlightObjectHandle flightObjectHandle;
+	uint32_t id;
+	uint8_t level;
+	// Set if the slot still has an alarm in the current update.
+	uint8_t isSeen;
+} TAlarmEventSlot;
+
+// Flight path of an other flight object in the ground station mode, see
+// predictionCalculateAlarmStatesGround.
+typedef struct {
+	// The predicted positions and the cone radii as if it were our own
+	// flight path.
+	TConeCheckOwn path;
+	// Squared velocity at t = 0.
+	float vMsSqu;
+#if PREDICTION_REACHABILITY_FILTER == 1
+	// Bounding box of the predicted positions.
+	TVector pathMin;
+	TVector pathMax;
+#endif
+	int isValid;
+} TGroundFlightPath;
+
+// Sink of the input recorder (InputRecorder.h): appends size bytes to the
+// recording.
+typedef void (*TInputRecorderWrite)(void *user, const uint8_t *data, int size);
+
+// Alarm of one other flight object, see Prediction.c.
+typedef struct {
+	EAlarmLevel level;
+	int timeToEncounterSec;
+	TVector curDistance;
+} TPredictionResult;
+
+// Scratch data for the prediction of one other flight object; one per
+// prediction thread (Prediction.c).
+typedef struct {
+	TFlightPathExtrapolationData fpe;
+#if FLIGHT_OBJECT_OTHER_PATH_CACHE == 0 || FLIGHT_OBJECT_OTHER_PATH_CACHE_QUANTIZED == 1
+	// Predicted positions of the current other flight object.
+	TFlightPath otherPath;
+#endif
+} TPredictionWorker;
+
+#if PREDICTION_THREADS_MAX > 1
+// Threads of predictionCalculateAlarmStatesParallel, started once with the
+// context; the calling thread is thread 0 (Prediction.c).
+typedef struct {
+	pthread_t threads[PREDICTION_THREADS_MAX];
+	// Number of threads including the calling thread, 0 if not started.
+	int nofThreads;
+	// Index of the worker of the next thread that starts.
+	int nextThreadIx;
+	pthread_mutex_t mutex;
+	// Signals a new job (or the exit) to the threads.
+	pthread_cond_t jobCond;
+	// Signals the end of the job to the calling thread.
+	pthread_cond_t doneCond;
+	int isExiting;
+	// The current job: its number (from 1 on), the number of threads still
+	// working on it, its time stamp and the next flight object to be taken.
+	uint32_t jobNr;
+	int nofBusy;
+	uint32_t ts;
+	int nextIx;
+} TPredictionThreads;
+#endif
+
+// Capacities of a context, see ocapContextInitWithMemory.
+typedef struct {
+	// Maximum number of other flight objects that we can track
+	// (1 ... OCAP_CAPACITY_FLIGHT_OBJECTS_MAX).
+	int flightObjects;
+	// Maximum number of alarm states (1 ... OCAP_CAPACITY_ALARM_STATES_MAX).
+	int alarmStates;
+	// Maximum number of queued received updates (see RxQueue.h), rounded
+	// up to a power of 2; 0 if the queue isn't used.
+	int rxQueueLength;
+	// Maximum number of aircraft filtered by alarmServiceUpdate
+	// (0 ... OCAP_CAPACITY_ALARM_SERVICE_ENTRIES_MAX, 0 if not used).
+	int alarmServiceEntries;
+	// Length of the queue of alarm events (see AlarmEventQueue.h),
+	// rounded up to a power of 2; 0 if the queue isn't used.
+	int alarmEventQueueLength;
+	// Maximum number of alarm states per flight object in the ground
+	// station mode (0 ... OCAP_CAPACITY_GROUND_ALARM_STATES_MAX, 0 if the
+	// mode isn't used), see predictionCalculateAlarmStatesGround.
+	int groundAlarmStates;
+	// Number of threads of predictionCalculateAlarmStatesParallel, including
+	// the calling thread (1 ... PREDICTION_THREADS_MAX). They are started by
+	// ocapContextInitWithMemory and stopped by ocapContextExit.
+	int predictionThreads;
+} TOcapCapacities;
+
+#define OCAP_CAPACITY_FLIGHT_OBJECTS_MAX 32767
+#define OCAP_CAPACITY_ALARM_STATES_MAX 32767
+#define OCAP_CAPACITY_ALARM_SERVICE_ENTRIES_MAX 32767
+#define OCAP_CAPACITY_GROUND_ALARM_STATES_MAX 255
+
+// All state of the library is kept in a context object, so that
+// several independent instances (e.g. one per own aircraft) can
+// run in the same process, also on different threads.
+// A context must only be used by one thread at a time.
+typedef struct {
+	// Local frame of the stored positions (LocalFrame.c).
+	TLocalFrame localFrame;
+
+	// Flight object list (FlightObjectList.c).
+	TFlightObjectOwn flightObjectOwn;
+	TFlightObjectOther *flightObjects;
+#if FLIGHT_OBJECT_OTHER_PATH_CACHE == 1
+	// Per slot: cached flight path (cold data, see TFlightPathCache).
+	TFlightPathCache *flightObjectPathCaches;
+#endif
+	int flightObjectCapacity;
+	// Number of slots in use so far (allocated or released).
+	int flightObjectCount;
+	// Released slots: slot + 1 of the first one and per slot of the next
+	// one (0 is the end of the list).
+	int flightObjectFreeFirst;
+	uint16_t *flightObjectFreeNext;
+#if FLIGHT_OBJECT_LIST_ID_INDEX == 1
+	// Hash index from ID to list slot + 1 (0 is an empty entry);
+	// its length is a power of 2, at least twice the capacity.
+	uint16_t *flightObjectIndex;
+	int flightObjectIndexMask;
+#endif
+#if FLIGHT_OBJECT_LIST_GRID == 1
+	// Spatial grid index: slot + 1 of the first flight object per bucket
+	// (0 is the end of the list); the last bucket holds the fast ones.
+	uint16_t flightObjectGridFirst[FLIGHT_OBJECT_LIST_GRID_BUCKETS + 1];
+	// Per slot: next flight object in the bucket, bucket (-1 if not in
+	// the grid) and grid cell.
+	uint16_t *flightObjectGridNext;
+	int16_t *flightObjectGridBucket;
+	int32_t *flightObjectGridCellX;
+	int32_t *flightObjectGridCellY;
+	// Slots selected by flightObjectListSelectOthers (1 bit per slot).
+	uint32_t *flightObjectGridSelected;
+#endif
+
+	// Queue of received updates (RxQueue.c). The producers increment the
+	// head, the prediction the tail.
+	TRxQueueEntry *rxQueue;
+	uint32_t rxQueueMask;
+	uint32_t rxQueueHead;
+	uint32_t rxQueueTail;
+	uint32_t rxQueueOverflows;
+	uint32_t rxQueueRejected;
+
+	// Queue of alarm events (AlarmEventQueue.c). The prediction (single
+	// producer) increments the head, the consumer the tail.
+	TAlarmEvent *alarmEventQueue;
+	uint32_t alarmEventQueueMask;
+	uint32_t alarmEventQueueHead;
+	uint32_t alarmEventQueueTail;
+	uint32_t alarmEventQueueOverflows;
+	// Per flight object slot: reported alarm level, and the slots with a
+	// reported alarm level (or still to be removed).
+	TAlarmEventSlot *alarmEventSlots;
+	uint16_t *alarmEventActiveSlots;
+	int alarmEventActiveCount;
+
+	// Alarm state list (AlarmStateList.c). The alarm states stay in place;
+	// the heap orders them by ascending priority (lowest at the root).
+	TAlarmState *alarmStates;
+	int alarmStateCapacity;
+	int alarmStateSize;
+	// Per alarm state: sequence number of the insertion (for equal
+	// priorities) and position in the heap.
+	uint32_t *alarmStateSeq;
+	int *alarmStateHeapPos;
+	uint32_t alarmStateNextSeq;
+	int *alarmStateHeap;
+	// Alarm states by descending priority, see alarmStateListGetAtIndex.
+	int *alarmStateOrder;
+	int alarmStateOrderIsValid;
+	// Hash index from the flight object handle to the alarm state + 1
+	// (0 is an empty entry); its length is a power of 2, at least twice
+	// the capacity.
+	uint16_t *alarmStateIndex;
+	int alarmStateIndexMask;
+
+	// Ground station mode (predictionCalculateAlarmStatesGround and
+	// GroundAlarmList.c). Per flight object slot: its flight path, its
+	// alarm states (groundAlarmStateCapacity per slot, by descending
+	// priority) and their number.
+	TGroundFlightPath *groundFlightPaths;
+	TAlarmState *groundAlarmStates;
+	uint8_t *groundAlarmStateCounts;
+	int groundAlarmStateCapacity;
+
+	// Prediction parameters and data (Prediction.c).
+	float k;
+	float facLevel2;
+	float facLevel1;
+	TConeCheckOwn ownFlightPath;
+	// Model and (for the linear model) velocity of our own flight path.
+	EOcapPathModel ownPathModel;
+	TVector ownVel;
+#if PREDICTION_REACHABILITY_FILTER == 1
+	// Bounding box of our own predicted flight path.
+	TVector ownFlightPathMin;
+	TVector ownFlightPathMax;
+#endif
+	// Extrapolation data of our own flight path.
+	TFlightPathExtrapolationData fpe;
+#if FLIGHT_OBJECT_LIST_GRID == 1
+	// Number of the current prediction iteration.
+	uint32_t predictionNr;
+#endif
+	TPredictionWorker predictionWorkers[PREDICTION_THREADS_MAX];
+#if PREDICTION_THREADS_MAX > 1
+	// Per slot: alarm of the flight object in the current parallel
+	// prediction.
+	TPredictionResult *predictionResults;
+	TPredictionThreads predictionThreads;
+#endif
+
+	// The simulation code can inject a pointer of flightObjectCapacity
+	// TVector arrays of length T_MAX_SEC here.
+	TVector *otherFlightPath;
+	// The simulation code can inject a pointer of flightObjectCapacity
+	// arrays of uint32_t here. It needs to clear this array before each
+	// prediction and can retrieve the idNr of the aircraft after the
+	// prediction.
+	uint32_t *otherFlightPathIdNr;
+
+	// Alarm service (AlarmService.c): the most critical alarm and the
+	// table of all filtered alarms.
+	TAlarmServiceEntry alarmServiceEntry;
+	TAlarmServiceEntry *alarmServiceEntries;
+	int alarmServiceCapacity;
+	int alarmServiceCount;
+	// Per flight object slot: entry + 1 in the table (0 if none).
+	uint16_t *alarmServiceSlotEntry;
+	// Per level: flight object slot + 1 of the first entry with this level
+	// at the end of the last alarmServiceUpdate (0 if none).
+	uint16_t alarmServiceLevelFirst[3 * ALARM_SERVICE_FACTOR + 1];
+
+	// Input recorder (InputRecorder.c): sink and its argument (0 if not
+	// recording), and the nesting of recorded methods that are called by
+	// other recorded methods (their calls aren't recorded).
+	TInputRecorderWrite inputRecorderWrite;
+	void *inputRecorderUser;
+	int inputRecorderSuspended;
+
+} TOcapContext;
+
+
+// Fills in the default capacities FLIGHT_OBJECT_LIST_LENGTH,
+// ALARM_STATE_LIST_LENGTH, RX_QUEUE_LENGTH, ALARM_SERVICE_LIST_LENGTH and
+// ALARM_EVENT_QUEUE_LENGTH of Configuration.h, without the ground station
+// mode and with 1 prediction thread.
+void ocapCapacitiesInitDefault(TOcapCapacities *capacities);
+
+// Returns the number of bytes of memory needed for a context with the
+// given capacities, or 0 if the capacities are invalid.
+size_t ocapContextGetMemorySize(const TOcapCapacities *capacities);
+
+// Call this method once before using the context with any other method.
+// All tables of the context are placed in mem, which must provide at
+// least ocapContextGetMemorySize bytes and stay valid as long as the
+// context is used. The library doesn't allocate any memory on its own.
+// Returns 0 on success, -1 if the capacities are invalid or the memory
+// is too small.
+int ocapContextInitWithMemory(TOcapContext *ctx,
+	const TOcapCapacities *capacities, void *mem, size_t memSize);
+
+// Call this method once when the context is no longer used, before its
+// memory is released or it is initialized again. Stops the threads of the
+// parallel prediction.
+void ocapContextExit(TOcapContext *ctx);
+
+#endif // __OCAP_CONTEXT_H__
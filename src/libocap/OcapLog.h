@@ -47,7 +47,7 @@ void ocapLogFlVec(int own, TVector *pos, TVector *vel);
 void ocapLogFlTN(int nr, TVector *vecT, TVector *vecN);
 
 void ocapLogFlOwn(TFlightObjectOwn *flOwn);
-void ocapLogFlOwnPath(TVector *ownFlightPath);
+void ocapLogFlOwnPath(TFlightPath *ownFlightPath);
 void ocapLogFlOtherPath1(TVector *otherPos, int t);
 void ocapLogFlOtherTs(int rxTs, int ts);
 
@@ -71,11 +71,13 @@ void ocapLogFlOwn(TFlightObjectOwn *flOwn)
 		(int)flOwn->rxPos.x, (int)flOwn->rxPos.y);
 }
 
-void ocapLogFlOwnPath(TVector *ownFlightPath)
+void ocapLogFlOwnPath(TFlightPath *ownFlightPath)
 {
 	for (int i = 0; i < 4; i++) {
+		TVector pos;
+		flightPathExtrapolationGetPathPosition(ownFlightPath, i, &pos);
 		printf("OCAP,FL-OWN-PATH,%d,%d,%d\n",
-			i, (int)ownFlightPath[i].x, (int)ownFlightPath[i].y);
+			i, (int)pos.x, (int)pos.y);
 	}
 }
 
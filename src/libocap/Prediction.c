@@ -33,151 +33,565 @@
 //
 
 #include <stddef.h>
+#include <string.h>
+#include <math.h>
 #include "Configuration.h"
+#if PREDICTION_THREADS_MAX > 1
+#include <pthread.h>
+#endif
 #include "FlightObjectOwn.h"
 #include "FlightObjectOther.h"
 #include "FlightObjectList.h"
 #include "FlightPathExtrapolation.h"
 #include "Prediction.h"
 #include "AlarmStateList.h"
+#include "ConeCheck.h"
+#include "RxQueue.h"
+#include "AlarmEventQueue.h"
+#include "GroundAlarmList.h"
+#include "InputRecorder.h"
+#include "FastMath.h"
 #include "OcapLog.h"
 
 
-// Made this globally visible for the simulation
-/* static */ TVector sOwnFlightPath[T_MAX_SEC];
-static float sOwnVelMsSqu[T_MAX_SEC];
+static void predictionPrepare(TOcapContext *ctx, TOcapContext *sets, int nofSets);
 
+static void predictionExtrapolateOwnFlightPath(
+	TOcapContext *ctx, TFlightObjectOwn *f, TOcapContext *sets, int nofSets);
 
-// The simulation code can inject a pointer of FLIGHT_OBJECT_LIST_LENGTH
-// TVector arrays of length T_MAX_SEC here.
-TVector *sOtherFlightPath;
+static int predictionCalculateOther(TOcapContext *ctx, TPredictionWorker *w,
+	int i, uint32_t ts, TOcapContext *sets, int nofSets, TPredictionResult *result);
 
-// The simulation code can inject a pointer of FLIGHT_OBJECT_LIST_LENGTH
-// arrays of uint32_t here. It needs to clear this array before each
-// prediction and can retrieve the idNr of the aircraft after the
-// prediction.
-uint32_t *sOtherFlightPathIdNr;
+static void predictionAddAlarmState(
+	TOcapContext *set, TFlightObjectOther *f, TPredictionResult *result);
 
-static float sK = 30;
-static float sFacLevel2 = 2;
-static float sFacLevel1 = 3;
+static void predictionAgeOtherFlightObjects(TOcapContext *ctx);
 
-static TFlightPathExtrapolationData sFpe;
+static int32_t predictionPrepareExtrapolationOtherFlightPath(
+	TPredictionWorker *w, TFlightObjectOther *f, uint32_t ts);
 
+static int32_t predictionUpdateOtherFlightObject(
+	TPredictionWorker *w, TFlightObjectOther *f, uint32_t ts);
 
-static void predictionExtrapolateOwnFlightPath(
-	TFlightObjectOwn *f);
+static TFlightPath *predictionExtrapolateOtherFlightPath(TOcapContext *ctx,
+	TPredictionWorker *w, TFlightObjectOther *f, int32_t deltaSec);
+
+static void predictionInvalidateOtherFlightPath(TFlightObjectOther *f);
+
+#if FLIGHT_OBJECT_OTHER_PATH_CACHE == 1 && FLIGHT_OBJECT_OTHER_PATH_CACHE_QUANTIZED == 1
+static void predictionLoadCachedPath(TFlightPathCache *c, TFlightPath *path, int tFrom);
+static int predictionStoreCachedPath(TFlightPathCache *c, TFlightPath *path, int tFrom);
+#endif
+
+static int predictionCheckOtherFlightPath(
+	TOcapContext *ctx, TPredictionWorker *w, TOcapContext *set,
+	TFlightPath *otherPath, int isLinear, int32_t startSec, float vOtherMsSqu,
+	TPredictionResult *result);
+
+static int predictionGetNextOther(TOcapContext *ctx, int i);
+
+#if PREDICTION_THREADS_MAX > 1
+static void *predictionThreadMain(void *arg);
+static void predictionRunJob(TOcapContext *ctx, TPredictionWorker *w);
+#endif
+
+#if FLIGHT_OBJECT_LIST_GRID == 1
+// The extrapolated positions are at most 2*v*t away from the received
+// position (for the arc model |_r(t)_ - _ri_| <= (v + k*r)*t with k = v/r),
+// with t <= T_MAX_SEC + 4, see PREDICTION_IS_RX_START.
+#define PREDICTION_GRID_MARGIN_MTR \
+	(2.0f * FLIGHT_OBJECT_LIST_GRID_V_MAX_MS * (T_MAX_SEC + 4) + 10.0f)
+
+static void predictionSelectOtherFlightObjects(
+	TOcapContext *ctx, TFlightObjectOwn *fOwn);
+
+static void predictionVisitOther(TOcapContext *ctx, TFlightObjectOther *f);
+#endif
+
+static int predictionPrepareGroundFlightPath(
+	TOcapContext *ctx, TPredictionWorker *w, int i, uint32_t ts);
+
+static void predictionCheckGroundPair(TOcapContext *ctx, int i1, int i2);
+
+static void predictionAddGroundAlarmState(TOcapContext *ctx, int iOwn, int iOther);
 
-static void predictionPrepareExtrapolationOtherFlightPath(
-	TFlightObjectOther *f, uint32_t ts);
+// Avoid too many extrapolation steps in case of a problem;
+// in this case, the path starts at the received position.
+#define PREDICTION_IS_RX_START(deltaSec) ((deltaSec) < 0 || (deltaSec) > 3)
 
-static TAlarmState *predictionCalculateAlarmStateForFlightObject(
-	int t,
-	TVector *posSelf, float vOwnMsSqu,
-	TFlightObjectOther *f, TVector *posF, float vFmsSqu);
+#if PREDICTION_REACHABILITY_FILTER == 1
+// Tolerance for rounding errors of the predicted positions.
+#define PREDICTION_REACH_TOLERANCE_MTR 10.0f
 
-void predictionInit(float k, float facLevel2, float facLevel1)
+static void predictionCalculatePathBounds(
+	TFlightPathExtrapolationData *fpe, int32_t startSec, TVector *min, TVector *max);
+
+static int predictionIsOutOfReach(TOcapContext *ctx, TPredictionWorker *w,
+	TFlightObjectOther *f, int32_t startSec, TOcapContext *sets, int nofSets);
+
+static float predictionGetGap(float min1, float max1, float min2, float max2);
+
+static float predictionGetReach(float distMax);
+#endif
+
+void predictionInit(TOcapContext *ctx, float k, float facLevel2, float facLevel1)
 {
-	sK = k;
-	sFacLevel2 = facLevel2;
-	sFacLevel1 = facLevel1;
+	inputRecorderRecordPredictionInit(ctx, k, facLevel2, facLevel1);
+
+	ctx->k = k;
+	ctx->facLevel2 = facLevel2;
+	ctx->facLevel1 = facLevel1;
 }
 
-void predictionCalculateAlarmStates(uint32_t ts)
+void predictionCalculateAlarmStates(TOcapContext *ctx, uint32_t ts)
 {
-	// Start with no alarms.
-	alarmStateListClear();
+	predictionCalculateAlarmStatesSweep(ctx, ts, NULL, 0);
+}
 
-	// Extrapolate our own flight path.
-	TFlightObjectOwn *fOwn = flightObjectListGetOwn();
-	ocapLogFlOwn(fOwn);
+void predictionCalculateAlarmStatesSweep(
+	TOcapContext *ctx, uint32_t ts, TOcapContext *sets, int nofSets)
+{
+	predictionPrepare(ctx, sets, nofSets);
+
+	// Loop through all objects in the neighbourhood to detect potential collisions.
+	TPredictionWorker *w = &ctx->predictionWorkers[0];
+	TPredictionResult result;
+	int nofFlightObjectsOther = flightObjectListGetOtherCount(ctx);
+	for (int i = predictionGetNextOther(ctx, 0); i < nofFlightObjectsOther;
+			i = predictionGetNextOther(ctx, i + 1)) {
+		if (predictionCalculateOther(ctx, w, i, ts, sets, nofSets, &result)) {
+			predictionAddAlarmState(ctx, flightObjectListGetOtherAtIndex(ctx, i), &result);
+		}
+	}
 
-	predictionExtrapolateOwnFlightPath(fOwn);
+	predictionAgeOtherFlightObjects(ctx);
+	alarmEventQueueUpdate(ctx, ts);
 
-	ocapLogFlOwnPath(&sOwnFlightPath[0]);
+	// Recorded at the end, after the queued updates that it applied.
+	inputRecorderRecordPrediction(ctx, INPUT_RECORD_PREDICTION, ts);
+}
 
-	// Loop through all objects in the neighbourhood to detect potential collisions.
-	int nofFlightObjectsOther = flightObjectListGetOtherCount();
-	for (int i = 0; i < nofFlightObjectsOther; i++) {
+#if PREDICTION_THREADS_MAX > 1
+void predictionCalculateAlarmStatesParallel(TOcapContext *ctx, uint32_t ts)
+{
+	TPredictionThreads *p = &ctx->predictionThreads;
 
-		TFlightObjectOther *fOther = flightObjectListGetOtherAtIndex(i);
+	predictionPrepare(ctx, NULL, 0);
 
-		// Skip flight objects for which we have no valid data.
-		if (fOther->state == FOS_INIT || fOther->state == FOS_UNALLOCATED) {
-			ocapLogStrInt("FLOBJ-UNINIT", i);
-			continue;
+	// Hand the job to the threads; the calling thread is thread 0. The
+	// threads fetch chunks of flight objects until all are done.
+	pthread_mutex_lock(&p->mutex);
+	p->ts = ts;
+	p->nextIx = 0;
+	p->nofBusy = p->nofThreads - 1;
+	p->jobNr++;
+	pthread_cond_broadcast(&p->jobCond);
+	pthread_mutex_unlock(&p->mutex);
+
+	predictionRunJob(ctx, &ctx->predictionWorkers[0]);
+
+	pthread_mutex_lock(&p->mutex);
+	while (p->nofBusy > 0) {
+		pthread_cond_wait(&p->doneCond, &p->mutex);
+	}
+	pthread_mutex_unlock(&p->mutex);
+
+	// Merge the results in the order of the serial prediction.
+	int nofFlightObjectsOther = flightObjectListGetOtherCount(ctx);
+	for (int i = predictionGetNextOther(ctx, 0); i < nofFlightObjectsOther;
+			i = predictionGetNextOther(ctx, i + 1)) {
+		TPredictionResult *r = &ctx->predictionResults[i];
+		if (r->level != ALARM_LEVEL_NONE) {
+			predictionAddAlarmState(ctx, flightObjectListGetOtherAtIndex(ctx, i), r);
 		}
+	}
 
-		// If we have received data, we need to apply it to the flight object.
-		predictionPrepareExtrapolationOtherFlightPath(fOther, ts);
+	predictionAgeOtherFlightObjects(ctx);
+	alarmEventQueueUpdate(ctx, ts);
 
-		// Square of the other aircraft's velocity.
-		float vOtherMsSqu =
-			fOther->vel_i0.x * fOther->vel_i0.x
-			+ fOther->vel_i0.y * fOther->vel_i0.y
-			+ fOther->vel_i0.z * fOther->vel_i0.z;
+	// Replayed with predictionCalculateAlarmStates (same alarm states).
+	inputRecorderRecordPrediction(ctx, INPUT_RECORD_PREDICTION, ts);
+}
 
-		// Extrapolate into the future and check for potential collisions.
-		// We remember the current distance (at t=0) to the other aircraft
-		// in the alarm state, if an alarm state is generated.
-		TAlarmState *alarmStateForOther = NULL;
-		TVector distToOther;
-		for (int t = 0; t < T_MAX_SEC; t += T_DELTA_SEC) {
+void predictionStartThreads(TOcapContext *ctx, int nofThreads)
+{
+	TPredictionThreads *p = &ctx->predictionThreads;
+	pthread_mutex_init(&p->mutex, NULL);
+	pthread_cond_init(&p->jobCond, NULL);
+	pthread_cond_init(&p->doneCond, NULL);
+	p->isExiting = 0;
+	p->jobNr = 0;
+	p->nextThreadIx = 1;
+
+	// If a thread can't be started, the others do its part.
+	p->nofThreads = 1;
+	while (p->nofThreads < nofThreads && p->nofThreads < PREDICTION_THREADS_MAX
+			&& pthread_create(&p->threads[p->nofThreads], NULL,
+				predictionThreadMain, ctx) == 0) {
+		p->nofThreads++;
+	}
+}
 
-			flightPathExtrapolationExecute(&sFpe);
+void predictionStopThreads(TOcapContext *ctx)
+{
+	TPredictionThreads *p = &ctx->predictionThreads;
+	if (!p->nofThreads) {
+		return;
+	}
 
-			// Compare our position to that of the other object.
-			TVector *ownPos = &sOwnFlightPath[t];
-			float ownVelMsSqu = sOwnVelMsSqu[t];
-			TVector *otherPos = &sFpe.ri_vec;
+	pthread_mutex_lock(&p->mutex);
+	p->isExiting = 1;
+	pthread_cond_broadcast(&p->jobCond);
+	pthread_mutex_unlock(&p->mutex);
+	for (int t = 1; t < p->nofThreads; t++) {
+		pthread_join(p->threads[t], NULL);
+	}
+	p->nofThreads = 0;
 
-			// Remember the distance at t=0 to store it in a potential alarm state.
-			if (t == 0) {
-				vectorCopy(&distToOther, otherPos);
-				vectorSubtractVector(&distToOther, ownPos);
-			}
+	pthread_cond_destroy(&p->doneCond);
+	pthread_cond_destroy(&p->jobCond);
+	pthread_mutex_destroy(&p->mutex);
+}
 
-			// Provide predicted flight paths to the simulation code.
-			if (sOtherFlightPath && sOtherFlightPathIdNr) {
-				int offset = i * T_MAX_SEC + t;
-				sOtherFlightPath[offset].x = otherPos->x;
-				sOtherFlightPath[offset].y = otherPos->y;
-				sOtherFlightPath[offset].z = otherPos->z;
-				sOtherFlightPathIdNr[i] = fOther->id;
-			}
+static void *predictionThreadMain(void *arg)
+{
+	TOcapContext *ctx = (TOcapContext *)arg;
+	TPredictionThreads *p = &ctx->predictionThreads;
+
+	pthread_mutex_lock(&p->mutex);
+	TPredictionWorker *w = &ctx->predictionWorkers[p->nextThreadIx++];
+	// The first job may have been handed out before this thread got here.
+	uint32_t jobNr = 0;
+	for (;;) {
+		while (p->jobNr == jobNr && !p->isExiting) {
+			pthread_cond_wait(&p->jobCond, &p->mutex);
+		}
+		if (p->isExiting) {
+			break;
+		}
+		jobNr = p->jobNr;
+		pthread_mutex_unlock(&p->mutex);
+
+		predictionRunJob(ctx, w);
 
-			if (t < 4) {
-				ocapLogFlOtherPath1(otherPos, t);
+		pthread_mutex_lock(&p->mutex);
+		if (--p->nofBusy == 0) {
+			pthread_cond_signal(&p->doneCond);
+		}
+	}
+	pthread_mutex_unlock(&p->mutex);
+	return NULL;
+}
+
+// Predicts chunks of flight objects of the current job until all are taken.
+static void predictionRunJob(TOcapContext *ctx, TPredictionWorker *w)
+{
+	TPredictionThreads *p = &ctx->predictionThreads;
+	int nofFlightObjectsOther = flightObjectListGetOtherCount(ctx);
+
+	for (;;) {
+		pthread_mutex_lock(&p->mutex);
+		int from = p->nextIx;
+		p->nextIx += PREDICTION_THREAD_CHUNK;
+		uint32_t ts = p->ts;
+		pthread_mutex_unlock(&p->mutex);
+		if (from >= nofFlightObjectsOther) {
+			return;
+		}
+		int to = from + PREDICTION_THREAD_CHUNK;
+		if (to > nofFlightObjectsOther) {
+			to = nofFlightObjectsOther;
+		}
+
+		// Each thread only writes the data of its flight objects.
+		for (int i = predictionGetNextOther(ctx, from); i < to;
+				i = predictionGetNextOther(ctx, i + 1)) {
+			TPredictionResult *r = &ctx->predictionResults[i];
+			if (!predictionCalculateOther(ctx, w, i, ts, NULL, 0, r)) {
+				r->level = ALARM_LEVEL_NONE;
 			}
+		}
+	}
+}
+#endif
 
-			TAlarmState *newAlarmState = predictionCalculateAlarmStateForFlightObject(
-				t, ownPos, ownVelMsSqu, fOther, otherPos, vOtherMsSqu);
-			if (newAlarmState) {
-				alarmStateForOther = newAlarmState;
+void predictionCalculateAlarmStatesGround(TOcapContext *ctx, uint32_t ts)
+{
+	if (!ctx->groundAlarmStateCapacity) {
+		return;
+	}
+
+	flightObjectListReleaseExpiredOthers(ctx);
+	rxQueueDrain(ctx);
+	groundAlarmListClear(ctx);
+#if FLIGHT_OBJECT_LIST_GRID == 1
+	ctx->predictionNr++;
+#endif
+
+	// Extrapolate the flight path of every flight object once.
+	TPredictionWorker *w = &ctx->predictionWorkers[0];
+	int nofFlightObjectsOther = flightObjectListGetOtherCount(ctx);
+	for (int i = 0; i < nofFlightObjectsOther; i++) {
+		ctx->groundFlightPaths[i].isValid = predictionPrepareGroundFlightPath(ctx, w, i, ts);
+	}
+
+	// Check each pair of flight objects once.
+	for (int i1 = 0; i1 < nofFlightObjectsOther; i1++) {
+		if (!ctx->groundFlightPaths[i1].isValid) {
+			continue;
+		}
+		for (int i2 = i1 + 1; i2 < nofFlightObjectsOther; i2++) {
+			if (ctx->groundFlightPaths[i2].isValid) {
+				predictionCheckGroundPair(ctx, i1, i2);
 			}
 		}
+	}
+
+	predictionAgeOtherFlightObjects(ctx);
+	inputRecorderRecordPrediction(ctx, INPUT_RECORD_PREDICTION_GROUND, ts);
+}
+
+// Starts a prediction: releases the expired flight objects, applies the
+// queued received updates, clears the alarm states and extrapolates our
+// own flight path.
+static void predictionPrepare(TOcapContext *ctx, TOcapContext *sets, int nofSets)
+{
+	flightObjectListReleaseExpiredOthers(ctx);
+	rxQueueDrain(ctx);
+
+	// Start with no alarms.
+	alarmStateListClear(ctx);
+	for (int j = 0; j < nofSets; j++) {
+		alarmStateListClear(&sets[j]);
+	}
+
+	// Extrapolate our own flight path.
+	TFlightObjectOwn *fOwn = flightObjectListGetOwn(ctx);
+	ocapLogFlOwn(fOwn);
+
+	predictionExtrapolateOwnFlightPath(ctx, fOwn, sets, nofSets);
+
+	ocapLogFlOwnPath(&ctx->ownFlightPath.pos);
+
+#if FLIGHT_OBJECT_LIST_GRID == 1
+	// Only visit the flight objects that can come close to our flight path.
+	ctx->predictionNr++;
+	predictionSelectOtherFlightObjects(ctx, fOwn);
+#endif
+}
 
-		if (alarmStateForOther) {
-			vectorCopy(&alarmStateForOther->curDistanceToFlightObject, &distToOther);
+// Extrapolates the flight path of the i-th other flight object and checks
+// it against our own flight path. Returns 1 and the alarm for ctx in result
+// if there is one, 0 otherwise. The alarm states for the sets are added
+// directly. Only modifies the flight object and the scratch data in w.
+static int predictionCalculateOther(TOcapContext *ctx, TPredictionWorker *w,
+	int i, uint32_t ts, TOcapContext *sets, int nofSets, TPredictionResult *result)
+{
+	TFlightObjectOther *fOther = flightObjectListGetOtherAtIndex(ctx, i);
+
+	// Skip flight objects for which we have no valid data.
+	if (fOther->state == FOS_INIT || fOther->state == FOS_UNALLOCATED) {
+		ocapLogStrInt("FLOBJ-UNINIT", i);
+		return 0;
+	}
+
+#if FLIGHT_OBJECT_LIST_GRID == 1
+	predictionVisitOther(ctx, fOther);
+#endif
+
+	// If we have received data, we need to apply it to the flight object.
+	int32_t deltaSec = predictionUpdateOtherFlightObject(w, fOther, ts);
+	int32_t startSec = PREDICTION_IS_RX_START(deltaSec) ? 0 : deltaSec;
+
+#if PREDICTION_REACHABILITY_FILTER == 1
+	if (predictionIsOutOfReach(ctx, w, fOther, startSec, sets, nofSets)) {
+		ocapLogStrInt("FLOBJ-OUT-OF-REACH", fOther->id);
+		predictionInvalidateOtherFlightPath(fOther);
+		return 0;
+	}
+#endif
+
+	// Square of the other aircraft's velocity.
+	float vOtherMsSqu =
+		fOther->vel_i0.x * fOther->vel_i0.x
+		+ fOther->vel_i0.y * fOther->vel_i0.y
+		+ fOther->vel_i0.z * fOther->vel_i0.z;
+
+#if PREDICTION_LINEAR_SOLVER == 1
+	// If both flight paths are straight lines, we can solve for the
+	// encounter directly, without the extrapolated path.
+	int isLinear = w->fpe.predictionModel == OCAP_PATH_MODEL_LINEAR
+		&& ctx->ownPathModel == OCAP_PATH_MODEL_LINEAR;
+#else
+	int isLinear = 0;
+#endif
+
+	// Extrapolate into the future.
+	// The simulation code gets the predicted flight path in any case.
+	TFlightPath *otherPath = NULL;
+	if (!isLinear || ctx->otherFlightPath) {
+		otherPath = predictionExtrapolateOtherFlightPath(ctx, w, fOther, deltaSec);
+	} else {
+		predictionInvalidateOtherFlightPath(fOther);
+	}
+
+	// Provide predicted flight paths to the simulation code.
+	if (otherPath && ctx->otherFlightPath && ctx->otherFlightPathIdNr) {
+		for (int t = 0; t < T_MAX_SEC; t += T_DELTA_SEC) {
+			int offset = i * T_MAX_SEC + t;
+			flightPathExtrapolationGetPathPosition(
+				otherPath, t, &ctx->otherFlightPath[offset]);
 		}
+		ctx->otherFlightPathIdNr[i] = fOther->id;
+	}
+
+	for (int t = 0; otherPath && t < 4; t++) {
+		TVector otherPos;
+		flightPathExtrapolationGetPathPosition(otherPath, t, &otherPos);
+		ocapLogFlOtherPath1(&otherPos, t);
 	}
 
-	// Release the flight objects for which we didn't receive data for a long time.
+	// Check for potential collisions along the extrapolated path,
+	// for each parameter set.
+	TPredictionResult setResult;
+	for (int j = 0; j < nofSets; j++) {
+		if (predictionCheckOtherFlightPath(ctx, w, &sets[j],
+				otherPath, isLinear, startSec, vOtherMsSqu, &setResult)) {
+			predictionAddAlarmState(&sets[j], fOther, &setResult);
+		}
+	}
+	return predictionCheckOtherFlightPath(ctx, w, ctx,
+		otherPath, isLinear, startSec, vOtherMsSqu, result);
+}
+
+// Adds the alarm of f to the alarm states of set (ctx or a parameter set).
+static void predictionAddAlarmState(
+	TOcapContext *set, TFlightObjectOther *f, TPredictionResult *result)
+{
+	// We remember the current distance (at t=0) to the other aircraft
+	// in the alarm state, if an alarm state is generated.
+	TAlarmState *alarmStateForOther =
+		alarmStateListAdd(set, f, result->level, result->timeToEncounterSec);
+	if (alarmStateForOther) {
+		vectorCopy(&alarmStateForOther->curDistanceToFlightObject, &result->curDistance);
+	}
+}
+
+// Counts the time since the last received data; the flight objects for
+// which we didn't receive data for a long time are released at the start
+// of the next prediction (flightObjectListReleaseExpiredOthers).
+static void predictionAgeOtherFlightObjects(TOcapContext *ctx)
+{
+	int nofFlightObjectsOther = flightObjectListGetOtherCount(ctx);
 	for (int i = 0; i < nofFlightObjectsOther; i++) {
-		TFlightObjectOther *f = flightObjectListGetOtherAtIndex(i);
+		TFlightObjectOther *f = flightObjectListGetOtherAtIndex(ctx, i);
 		if (f->state != FOS_UNALLOCATED) {
 			f->timeSinceLastRxSec++;
-			if (f->timeSinceLastRxSec >= FLIGHT_OBJECT_TIME_TO_RELEASE_SEC) {
-				ocapLogStrInt("FLOBJ-RELEASE", f->id);
-				flightObjectListRemoveOtherAtIndex(i);
-			}
 		}
 	}
 }
 
+// Extrapolates the flight path of the i-th other flight object for the
+// ground station mode, with the cone radii as for our own flight path.
+// Returns 0 if the flight object has no valid data.
+static int predictionPrepareGroundFlightPath(
+	TOcapContext *ctx, TPredictionWorker *w, int i, uint32_t ts)
+{
+	TFlightObjectOther *f = flightObjectListGetOtherAtIndex(ctx, i);
+	if (f->state == FOS_INIT || f->state == FOS_UNALLOCATED) {
+		return 0;
+	}
+#if FLIGHT_OBJECT_LIST_GRID == 1
+	predictionVisitOther(ctx, f);
+#endif
+
+	int32_t deltaSec = predictionUpdateOtherFlightObject(w, f, ts);
+	int32_t startSec = PREDICTION_IS_RX_START(deltaSec) ? 0 : deltaSec;
+	// The path cache is only used by the prediction for our own aircraft.
+	predictionInvalidateOtherFlightPath(f);
+
+	TGroundFlightPath *g = &ctx->groundFlightPaths[i];
+	for (int t = 0; t < T_MAX_SEC; t += T_DELTA_SEC) {
+		TVector pos;
+		TVector vel;
+		flightPathExtrapolationEvaluate(&w->fpe, startSec + 1 + t, &pos, &vel);
+		coneCheckSetOwn(&g->path, ctx->k, t, &pos, &vel);
+	}
+	g->vMsSqu = f->vel_i0.x * f->vel_i0.x + f->vel_i0.y * f->vel_i0.y + f->vel_i0.z * f->vel_i0.z;
+#if PREDICTION_REACHABILITY_FILTER == 1
+	predictionCalculatePathBounds(&w->fpe, startSec, &g->pathMin, &g->pathMax);
+#endif
+
+	// Provide predicted flight paths to the simulation code.
+	if (ctx->otherFlightPath && ctx->otherFlightPathIdNr) {
+		for (int t = 0; t < T_MAX_SEC; t += T_DELTA_SEC) {
+			flightPathExtrapolationGetPathPosition(
+				&g->path.pos, t, &ctx->otherFlightPath[i * T_MAX_SEC + t]);
+		}
+		ctx->otherFlightPathIdNr[i] = f->id;
+	}
+	return 1;
+}
+
+// Checks the flight paths of the i1-th and i2-th other flight object
+// against each other and adds the alarms to both of them. The cone radius
+// depends on which one is the own aircraft (the compensation of the noise
+// differs), so the cone check is done in both directions.
+static void predictionCheckGroundPair(TOcapContext *ctx, int i1, int i2)
+{
+#if PREDICTION_REACHABILITY_FILTER == 1
+	// Skip the pair if the bounding boxes are too far apart.
+	TGroundFlightPath *g1 = &ctx->groundFlightPaths[i1];
+	TGroundFlightPath *g2 = &ctx->groundFlightPaths[i2];
+	TVector gap;
+	gap.x = predictionGetGap(g1->pathMin.x, g1->pathMax.x, g2->pathMin.x, g2->pathMax.x);
+	gap.y = predictionGetGap(g1->pathMin.y, g1->pathMax.y, g2->pathMin.y, g2->pathMax.y);
+	gap.z = predictionGetGap(g1->pathMin.z, g1->pathMax.z, g2->pathMin.z, g2->pathMax.z);
+	float distMax = coneCheckGetMaxRadius(&g1->path, g2->vMsSqu, ctx->facLevel2, ctx->facLevel1);
+	float distMax2 = coneCheckGetMaxRadius(&g2->path, g1->vMsSqu, ctx->facLevel2, ctx->facLevel1);
+	if (distMax2 > distMax) {
+		distMax = distMax2;
+	}
+	if (vectorGetLength(&gap) > predictionGetReach(distMax)) {
+		return;
+	}
+#endif
+
+	predictionAddGroundAlarmState(ctx, i1, i2);
+	predictionAddGroundAlarmState(ctx, i2, i1);
+}
+
+// Checks the flight path of the iOther-th other flight object against the
+// one of the iOwn-th and adds the alarm to the alarm states of iOwn.
+static void predictionAddGroundAlarmState(TOcapContext *ctx, int iOwn, int iOther)
+{
+	TGroundFlightPath *gOwn = &ctx->groundFlightPaths[iOwn];
+	TGroundFlightPath *gOther = &ctx->groundFlightPaths[iOther];
+
+	int timeToEncounterSec;
+	EAlarmLevel level = coneCheckCalculate(&gOwn->path, &gOther->path.pos,
+		gOther->vMsSqu, ctx->facLevel2, ctx->facLevel1, &timeToEncounterSec);
+	if (level == ALARM_LEVEL_NONE) {
+		return;
+	}
+
+	TAlarmState *a = groundAlarmListAdd(ctx,
+		flightObjectListGetOtherAtIndex(ctx, iOwn), flightObjectListGetOtherAtIndex(ctx, iOther),
+		level, timeToEncounterSec);
+	if (a) {
+		// The current distance (at t=0) to the other aircraft.
+		TVector ownPos;
+		flightPathExtrapolationGetPathPosition(&gOwn->path.pos, 0, &ownPos);
+		flightPathExtrapolationGetPathPosition(&gOther->path.pos, 0, &a->curDistanceToFlightObject);
+		vectorSubtractVector(&a->curDistanceToFlightObject, &ownPos);
+	}
+}
+
 static void predictionExtrapolateOwnFlightPath(
-	TFlightObjectOwn *f)
+	TOcapContext *ctx, TFlightObjectOwn *f, TOcapContext *sets, int nofSets)
 {
+	TFlightPathExtrapolationData *fpe = &ctx->fpe;
+
 	// TODO HIGH what if we didn't receive GPS info?
 
 	// Mark the object as "fresh".
@@ -190,40 +604,53 @@ static void predictionExtrapolateOwnFlightPath(
 		return;
 	}
 
-	vectorCopy(&sFpe.r0_vec, &f->pos_i[f->pos_vel_i_ctr - 1]);
-	vectorCopy(&sFpe.v0_vec, &f->vel_i[f->pos_vel_i_ctr - 1]);
-	vectorCopy(&sFpe.ri_vec, &f->rxPos);
-	vectorCopy(&sFpe.vi_vec, &f->rxVel);
+	vectorCopy(&fpe->r0_vec, &f->pos_i[f->pos_vel_i_ctr - 1]);
+	vectorCopy(&fpe->v0_vec, &f->vel_i[f->pos_vel_i_ctr - 1]);
+	vectorCopy(&fpe->ri_vec, &f->rxPos);
+	vectorCopy(&fpe->vi_vec, &f->rxVel);
 
 	// $TEST,1721390405.084,0,FL-OWN-FPE,745207,5256480,745207,5256496
-	ocapLogFpe(1, &sFpe);
+	ocapLogFpe(1, fpe);
 
-	flightPathExtrapolationPrepare2rv(&sFpe);
+	flightPathExtrapolationPrepare2rv(fpe);
 
 	// $TEST,1721390405.090,0,FL-OWN-FPE,1,2147483647,2147483647,2147483647,20
-	ocapLogRZxyV(1, &sFpe);
+	ocapLogRZxyV(1, fpe);
 
 	// Store our own Z and prediction model for the iConspicuity2 transmission.
-	flightObjectOwnActivateModel(f, &sFpe.z_vec, sFpe.predictionModel);
+	flightObjectOwnActivateModel(f, &fpe->z_vec, fpe->predictionModel);
 
 	// For all future points in time t ...
 	for (int t = 0; t < T_MAX_SEC; t += T_DELTA_SEC) {
 
-		// ... predict the position and velocity for our aircraft ...
-		flightPathExtrapolationExecute(&sFpe);
+		// ... predict the position and velocity for our aircraft
+		// and save them for later.
+		TVector pos;
+		TVector vel;
+		flightPathExtrapolationEvaluate(fpe, 1 + t, &pos, &vel);
+		coneCheckSetOwn(&ctx->ownFlightPath, ctx->k, t, &pos, &vel);
+		for (int j = 0; j < nofSets; j++) {
+			coneCheckSetOwn(&sets[j].ownFlightPath, sets[j].k, t, &pos, &vel);
+		}
+	}
 
-		// ... and save the position and velocity for later.
-		vectorCopy(&sOwnFlightPath[t], &sFpe.ri_vec);
-		float vSqu = sFpe.vi_vec.x * sFpe.vi_vec.x
-			+ sFpe.vi_vec.y * sFpe.vi_vec.y
-			+ sFpe.vi_vec.z * sFpe.vi_vec.z;
-		sOwnVelMsSqu[t] = vSqu;
+	ctx->ownPathModel = fpe->predictionModel;
+	vectorCopy(&ctx->ownVel, &fpe->vi_vec);
+	for (int j = 0; j < nofSets; j++) {
+		sets[j].ownPathModel = ctx->ownPathModel;
+		vectorCopy(&sets[j].ownVel, &ctx->ownVel);
 	}
+#if PREDICTION_REACHABILITY_FILTER == 1
+	predictionCalculatePathBounds(fpe, 0, &ctx->ownFlightPathMin, &ctx->ownFlightPathMax);
+#endif
 }
 
-static void predictionPrepareExtrapolationOtherFlightPath(
-	TFlightObjectOther *f, uint32_t ts)
+// Returns the number of seconds from the rx data to ts.
+static int32_t predictionPrepareExtrapolationOtherFlightPath(
+	TPredictionWorker *w, TFlightObjectOther *f, uint32_t ts)
 {
+	TFlightPathExtrapolationData *fpe = &w->fpe;
+
 	// Different scenarioes:
 	// - We received a packet in this iteration for this aircraft:
 	//   - Full data (r/v/z) available:  Full extrapolation/prediction.
@@ -243,119 +670,410 @@ static void predictionPrepareExtrapolationOtherFlightPath(
 		f->state = FOS_SINGLE_RV_USE;
 	}
 
-	vectorCopy(&sFpe.r0_vec, &f->pos_i0);
-	vectorCopy(&sFpe.v0_vec, &f->vel_i0);
-	vectorCopy(&sFpe.ri_vec, &f->rxPos);
-	vectorCopy(&sFpe.vi_vec, &f->rxVel);
+	vectorCopy(&fpe->r0_vec, &f->pos_i0);
+	vectorCopy(&fpe->v0_vec, &f->vel_i0);
+	vectorCopy(&fpe->ri_vec, &f->rxPos);
+	vectorCopy(&fpe->vi_vec, &f->rxVel);
 
 	// $TEST,1721390405.084,0,FL-OTHER-FPE,745207,5256480,745207,5256496
-	ocapLogFpe(0, &sFpe);
+	ocapLogFpe(0, fpe);
 
 	if (f->state == FOS_RVZ) {
 		// We have Z.
-		vectorCopy(&sFpe.z_vec, &f->z);
-		sFpe.predictionModel = f->pathModel;
-		flightPathExtrapolationPrepareRvz(&sFpe);
+		vectorCopy(&fpe->z_vec, &f->z);
+		fpe->predictionModel = f->pathModel;
+		flightPathExtrapolationPrepareRvz(fpe);
 
 	} else if (f->state == FOS_RV_2) {
 		// We can calculate Z.
-		flightPathExtrapolationPrepare2rv(&sFpe);
-		vectorCopy(&f->z, &sFpe.z_vec);
+		flightPathExtrapolationPrepare2rv(fpe);
+		vectorCopy(&f->z, &fpe->z_vec);
 
 	} else if (f->state == FOS_SINGLE_RV_USE) {
 		// We can't calculate Z; we use linear extrapolation.
 		// We have two (identical) points for the calculation.
-		flightPathExtrapolationPrepare2rv(&sFpe);
+		flightPathExtrapolationPrepare2rv(fpe);
 	}
 
-	ocapLogRZxyV(0, &sFpe);
+	ocapLogRZxyV(0, fpe);
 
 	ocapLogFlOtherTs(f->rxTs, ts);
 
-	// If the data has been received in this iteration, this is it.
-	int32_t deltaSec = (int32_t)(ts - f->rxTs);
-	if (deltaSec < 0
-				// Avoid too many extrapolation steps in case of a problem.
-				|| deltaSec > 3) {
+	// If the data has been received in this iteration, this is 0.
+	return (int32_t)(ts - f->rxTs);
+}
+
+// Prepares the extrapolation of f and updates its current position and
+// velocity. Returns the number of seconds from the rx data to ts.
+static int32_t predictionUpdateOtherFlightObject(
+	TPredictionWorker *w, TFlightObjectOther *f, uint32_t ts)
+{
+	TFlightPathExtrapolationData *fpe = &w->fpe;
+
+	int32_t deltaSec = predictionPrepareExtrapolationOtherFlightPath(w, f, ts);
+
+	if (PREDICTION_IS_RX_START(deltaSec)) {
 		ocapLogStrInt("ACTI_<=0_>3", (int)deltaSec);
 		// Activate the new data.
 		flightObjectOtherActivateRxData(f);
-		return;
+
+	} else if (deltaSec > 0) {
+		// The rx data hasn't been received in this iteration.
+		// Jump to the current position and velocity and copy it back
+		// for the future.
+		ocapLogStrInt("EXTRAP", deltaSec);
+		flightPathExtrapolationEvaluate(fpe, deltaSec, &f->pos_i0, &f->vel_i0);
+		f->ts = ts;
+
+	} else {
+		vectorCopy(&f->pos_i0, &fpe->ri_vec);
+		vectorCopy(&f->vel_i0, &fpe->vi_vec);
+		f->ts = ts;
 	}
 
-	// The rx data hasn't been received in this iteration.
-	// We run extrapolation steps to get the current position and velocity.
+	return deltaSec;
+}
 
-	while (deltaSec > 0) {
-		ocapLogStrInt("EXTRAP", deltaSec);
-		flightPathExtrapolationExecute(&sFpe);
-		deltaSec--;
+// Returns the predicted positions of f for t = 0 ... T_MAX_SEC-1.
+// Must be called after predictionUpdateOtherFlightObject.
+static TFlightPath *predictionExtrapolateOtherFlightPath(TOcapContext *ctx,
+	TPredictionWorker *w, TFlightObjectOther *f, int32_t deltaSec)
+{
+	TFlightPathExtrapolationData *fpe = &w->fpe;
+
+	int isRxStart = PREDICTION_IS_RX_START(deltaSec);
+	int32_t startSec = isRxStart ? 0 : deltaSec;
+
+#if FLIGHT_OBJECT_OTHER_PATH_CACHE == 1
+	TFlightPathCache *c = &ctx->flightObjectPathCaches[f - ctx->flightObjects];
+#if FLIGHT_OBJECT_OTHER_PATH_CACHE_QUANTIZED == 1
+	TFlightPath *path = &w->otherPath;
+#else
+	TFlightPath *path = &c->path;
+#endif
+
+	if (f->pathCacheIsValid && flightPathExtrapolationEqualsParameters(&c->fpeRx, fpe)) {
+		int wasRxStart = PREDICTION_IS_RX_START(c->deltaSec);
+
+		if (isRxStart && wasRxStart) {
+			// Same path as in the previous iteration.
+			c->deltaSec = deltaSec;
+#if FLIGHT_OBJECT_OTHER_PATH_CACHE_QUANTIZED == 1
+			predictionLoadCachedPath(c, path, 0);
+#endif
+			return path;
+		}
+
+		if (!isRxStart && !wasRxStart && deltaSec == c->deltaSec + 1) {
+			// Same path as in the previous iteration, 1 second later.
+			// Shift the path and extrapolate the new last position.
+			ocapLogStrInt("EXTRAP-CACHED", deltaSec);
+#if FLIGHT_OBJECT_OTHER_PATH_CACHE_QUANTIZED == 1
+			memmove(&c->path[0], &c->path[1], (T_MAX_SEC - 1) * sizeof(c->path[0]));
+			predictionLoadCachedPath(c, path, 0);
+			flightPathExtrapolationEvaluatePath(fpe, deltaSec + 1, path,
+				T_MAX_SEC - 1, T_MAX_SEC);
+			f->pathCacheIsValid = predictionStoreCachedPath(c, path, T_MAX_SEC - 1);
+#else
+			memmove(&path->x[0], &path->x[1], (T_MAX_SEC - 1) * sizeof(path->x[0]));
+			memmove(&path->y[0], &path->y[1], (T_MAX_SEC - 1) * sizeof(path->y[0]));
+			memmove(&path->z[0], &path->z[1], (T_MAX_SEC - 1) * sizeof(path->z[0]));
+			flightPathExtrapolationEvaluatePath(fpe, deltaSec + 1, path,
+				T_MAX_SEC - 1, T_MAX_SEC);
+#endif
+			c->deltaSec = deltaSec;
+			return path;
+		}
 	}
 
-	// Copy it back for the future.
-	vectorCopy(&f->pos_i0, &sFpe.ri_vec);
-	vectorCopy(&f->vel_i0, &sFpe.vi_vec);
-	f->ts = ts;
+	// Calculate the full path and remember the parameters.
+	f->pathCacheIsValid = 1;
+	c->deltaSec = deltaSec;
+	c->fpeRx = *fpe;
+#else
+	TFlightPath *path = &w->otherPath;
+#endif
+
+	// Extrapolate into the future.
+	flightPathExtrapolationEvaluatePath(fpe, startSec + 1, path, 0, T_MAX_SEC);
+
+#if FLIGHT_OBJECT_OTHER_PATH_CACHE == 1 && FLIGHT_OBJECT_OTHER_PATH_CACHE_QUANTIZED == 1
+	f->pathCacheIsValid = predictionStoreCachedPath(c, path, 0);
+#endif
+
+	return path;
 }
 
-static TAlarmState *predictionCalculateAlarmStateForFlightObject(
-	int t,
-	TVector *posSelf, float vOwnMsSqu,
-	TFlightObjectOther *f, TVector *posF, float vFmsSqu)
+#if FLIGHT_OBJECT_OTHER_PATH_CACHE == 1 && FLIGHT_OBJECT_OTHER_PATH_CACHE_QUANTIZED == 1
+// Copies the cached positions from tFrom on into path.
+static void predictionLoadCachedPath(TFlightPathCache *c, TFlightPath *path, int tFrom)
 {
-	float dx = posF->x - posSelf->x;
-	float dy = posF->y - posSelf->y;
-	float dz = posF->z - posSelf->z;
+	for (int t = tFrom; t < T_MAX_SEC; t++) {
+		TVector pos;
+		localFrameDequantize(&c->path[t], &pos);
+		flightPathExtrapolationSetPathPosition(path, t, &pos);
+	}
+	flightPathExtrapolationClearPadding(path);
+}
 
-	// To save performance and avoid sqrt, we work with the squared distance.
-	float distMtrSqu = dx*dx + dy*dy + dz*dz;
+// Stores the positions of path from tFrom on in the cache and rounds them
+// in path, so that the result doesn't depend on whether the path comes
+// from the cache. Returns 0 if a position is out of the range of the cache.
+static int predictionStoreCachedPath(TFlightPathCache *c, TFlightPath *path, int tFrom)
+{
+	int isInRange = 1;
+	for (int t = tFrom; t < T_MAX_SEC; t++) {
+		TVector pos;
+		flightPathExtrapolationGetPathPosition(path, t, &pos);
+		if (localFrameQuantize(&pos, &c->path[t])) {
+			localFrameDequantize(&c->path[t], &pos);
+			flightPathExtrapolationSetPathPosition(path, t, &pos);
+		} else {
+			isInRange = 0;
+		}
+	}
+	return isInRange;
+}
+#endif
+
+// Checks the predicted path in w against our own flight path with the
+// parameters of set (ctx or a parameter set of the sweep). Returns 1 and
+// the alarm in result if there is one, 0 otherwise. Must be called after
+// predictionExtrapolateOtherFlightPath (otherPath may be NULL if isLinear).
+static int predictionCheckOtherFlightPath(
+	TOcapContext *ctx, TPredictionWorker *w, TOcapContext *set,
+	TFlightPath *otherPath, int isLinear, int32_t startSec, float vOtherMsSqu,
+	TPredictionResult *result)
+{
+	TFlightPathExtrapolationData *fpe = &w->fpe;
+
+	int timeToEncounterSec;
+	EAlarmLevel level;
+#if PREDICTION_LINEAR_SOLVER == 1
+	if (isLinear) {
+		level = coneCheckCalculateLinear(&set->ownFlightPath, &set->ownVel,
+			fpe, startSec, vOtherMsSqu, set->facLevel2, set->facLevel1,
+			&timeToEncounterSec);
+	} else {
+		level = coneCheckCalculate(&set->ownFlightPath, otherPath,
+			vOtherMsSqu, set->facLevel2, set->facLevel1, &timeToEncounterSec);
+	}
+#else
+	level = coneCheckCalculate(&set->ownFlightPath, otherPath,
+		vOtherMsSqu, set->facLevel2, set->facLevel1, &timeToEncounterSec);
+#endif
+	if (level == ALARM_LEVEL_NONE) {
+		return 0;
+	}
+
+	// The current distance (at t=0) to the other aircraft.
+	TVector otherPos;
+	TVector otherVel;
+	flightPathExtrapolationEvaluate(fpe, startSec + 1, &otherPos, &otherVel);
+	TVector ownPos;
+	flightPathExtrapolationGetPathPosition(&ctx->ownFlightPath.pos, 0, &ownPos);
+	result->level = level;
+	result->timeToEncounterSec = timeToEncounterSec;
+	vectorCopy(&result->curDistance, &otherPos);
+	vectorSubtractVector(&result->curDistance, &ownPos);
+	return 1;
+}
 
-	// ocapLogStrInt("OCAP-DIST-M2", (int)distMtrSqu);
+// Call this if the predicted path of f hasn't been updated in this iteration.
+static void predictionInvalidateOtherFlightPath(TFlightObjectOther *f)
+{
+#if FLIGHT_OBJECT_OTHER_PATH_CACHE == 1
+	f->pathCacheIsValid = 0;
+#endif
+}
 
-	// Only check if within the limit.
-	if (distMtrSqu > DIST_MTR_SQU_CHECK_LIMIT) {
-		return NULL;
+#if PREDICTION_REACHABILITY_FILTER == 1
+// Calculates a bounding box of the positions predicted by
+// flightPathExtrapolationEvaluate for startSec+1 ... startSec+T_MAX_SEC.
+static void predictionCalculatePathBounds(
+	TFlightPathExtrapolationData *fpe, int32_t startSec, TVector *min, TVector *max)
+{
+	if (fpe->predictionModel == OCAP_PATH_MODEL_ARC) {
+		// The arc is a rotation in (_d_, _v_/k) with _d_ := _r_ - _Z_ for
+		// each axis separately (see flightPathExtrapolationEvaluate),
+		// so each axis stays within Z +/- sqrt(d^2 + (v/k)^2).
+		float k = fpe->v / fpe->r;
+		TVector d_vec;
+		vectorCopy(&d_vec, &fpe->ri_vec);
+		vectorSubtractVector(&d_vec, &fpe->z_vec);
+		TVector w_vec;
+		vectorCopy(&w_vec, &fpe->vi_vec);
+		vectorMultiplyScalar(&w_vec, 1.0f / k);
+
+		TVector a_vec;
+		a_vec.x = fastMathSqrt(d_vec.x * d_vec.x + w_vec.x * w_vec.x);
+		a_vec.y = fastMathSqrt(d_vec.y * d_vec.y + w_vec.y * w_vec.y);
+		a_vec.z = fastMathSqrt(d_vec.z * d_vec.z + w_vec.z * w_vec.z);
+
+		vectorCopy(min, &fpe->z_vec);
+		vectorSubtractVector(min, &a_vec);
+		vectorCopy(max, &fpe->z_vec);
+		vectorAddVector(max, &a_vec);
+		return;
 	}
 
-	uint32_t distMtrSquInt = (uint32_t)distMtrSqu;
-	EAlarmLevel newAlarmLevel = ALARM_LEVEL_NONE;
+	// Linear model: All positions are on the line from the first to the last.
+	// Spheric model: All positions are Z.
+	TVector last;
+	TVector vel;
+	flightPathExtrapolationEvaluate(fpe, startSec + 1, min, &vel);
+	flightPathExtrapolationEvaluate(fpe, startSec + T_MAX_SEC, &last, &vel);
+	vectorCopy(max, min);
+	if (last.x < min->x) {
+		min->x = last.x;
+	} else {
+		max->x = last.x;
+	}
+	if (last.y < min->y) {
+		min->y = last.y;
+	} else {
+		max->y = last.y;
+	}
+	if (last.z < min->z) {
+		min->z = last.z;
+	} else {
+		max->z = last.z;
+	}
+}
+
+// Returns 1 if f can't get into any of our alarm cones within T_MAX_SEC,
+// with the parameters of ctx and of all sets.
+// Must be called after predictionUpdateOtherFlightObject.
+static int predictionIsOutOfReach(TOcapContext *ctx, TPredictionWorker *w,
+	TFlightObjectOther *f, int32_t startSec, TOcapContext *sets, int nofSets)
+{
+	TFlightPathExtrapolationData *fpe = &w->fpe;
+
+	// Lower bound of the distance: Gap between the bounding boxes of both
+	// flight paths (including the altitude band in z).
+	TVector min;
+	TVector max;
+	predictionCalculatePathBounds(fpe, startSec, &min, &max);
+	TVector gap;
+	gap.x = predictionGetGap(min.x, max.x, ctx->ownFlightPathMin.x, ctx->ownFlightPathMax.x);
+	gap.y = predictionGetGap(min.y, max.y, ctx->ownFlightPathMin.y, ctx->ownFlightPathMax.y);
+	gap.z = predictionGetGap(min.z, max.z, ctx->ownFlightPathMin.z, ctx->ownFlightPathMax.z);
+	float distMin = vectorGetLength(&gap);
+
+	// If both flight paths are linear, the distance can't shrink faster
+	// than the relative velocity.
+	if (fpe->predictionModel == OCAP_PATH_MODEL_LINEAR
+			&& ctx->ownPathModel == OCAP_PATH_MODEL_LINEAR) {
+		TVector dist;
+		TVector vel;
+		TVector ownPos;
+		flightPathExtrapolationEvaluate(fpe, startSec + 1, &dist, &vel);
+		flightPathExtrapolationGetPathPosition(&ctx->ownFlightPath.pos, 0, &ownPos);
+		vectorSubtractVector(&dist, &ownPos);
+		vectorSubtractVector(&vel, &ctx->ownVel);
+		float distLinear = vectorGetLength(&dist) - vectorGetLength(&vel) * (T_MAX_SEC - 1);
+		if (distLinear > distMin) {
+			distMin = distLinear;
+		}
+	}
+
+	// Upper bound of the distance for an alarm.
+	float vOtherMsSqu =
+		f->vel_i0.x * f->vel_i0.x
+		+ f->vel_i0.y * f->vel_i0.y
+		+ f->vel_i0.z * f->vel_i0.z;
+	float distMax = coneCheckGetMaxRadius(
+		&ctx->ownFlightPath, vOtherMsSqu, ctx->facLevel2, ctx->facLevel1);
+	for (int j = 0; j < nofSets; j++) {
+		float distMaxSet = coneCheckGetMaxRadius(
+			&sets[j].ownFlightPath, vOtherMsSqu, sets[j].facLevel2, sets[j].facLevel1);
+		if (distMaxSet > distMax) {
+			distMax = distMaxSet;
+		}
+	}
+	return distMin > predictionGetReach(distMax);
+}
 
-	// Provide a lower bound (fixed safety zone) of 5m for each aircraft.
-	// TODO MED make this configurable, or dependent on the aircraft?
-	if (vOwnMsSqu < 25.0f) {
-		vOwnMsSqu = 25.0f;
+// Returns the gap between the intervals [min1, max1] and [min2, max2],
+// or 0 if they overlap.
+static float predictionGetGap(float min1, float max1, float min2, float max2)
+{
+	if (min1 > max2) {
+		return min1 - max2;
 	}
-	if (vFmsSqu < 25.0f) {
-		vFmsSqu = 25.0f;
+	if (min2 > max1) {
+		return min2 - max1;
 	}
+	return 0;
+}
 
-	// Check if the predicted position of the other flight object
-	// is in one of our 3 per-level truncated cones.
-	float dMinL3 = (1.0f + 1.0f/sK * t) * sqrtf(vOwnMsSqu + vFmsSqu);
-	// Compensate Z vector resolution in ADS-L.
-	dMinL3 += 0.001f * ALARM_Z_OTHER_COMPENSATION_MILLI_V * sqrtf(vFmsSqu);
-	// Compensate input vector noise.
-	dMinL3 += 0.001f * ALARM_Z_OWN_COMPENSATION_MILLI_V * sqrtf(vOwnMsSqu);
-	uint32_t dMinL3SquInt = (uint32_t)(dMinL3 * dMinL3);
-	uint32_t dMinL2SquInt = (uint32_t)(dMinL3 * dMinL3 * sFacLevel2 * sFacLevel2);
-	uint32_t dMinL1SquInt = (uint32_t)(dMinL3 * dMinL3 * sFacLevel1 * sFacLevel1);
+// Returns the largest distance for an alarm with the given maximum cone
+// radius, including the tolerance for rounding errors.
+static float predictionGetReach(float distMax)
+{
+	if (distMax * distMax > DIST_MTR_SQU_CHECK_LIMIT) {
+		distMax = sqrtf(DIST_MTR_SQU_CHECK_LIMIT);
+	}
+	return distMax * 1.01f + PREDICTION_REACH_TOLERANCE_MTR;
+}
+#endif
 
-	if (distMtrSquInt <= dMinL3SquInt) {
-		newAlarmLevel = ALARM_LEVEL_3;
+// Returns the index of the next flight object >= i to visit.
+static int predictionGetNextOther(TOcapContext *ctx, int i)
+{
+#if FLIGHT_OBJECT_LIST_GRID == 1
+	return flightObjectListGetNextSelected(ctx, i);
+#else
+	(void)ctx;
+	return i;
+#endif
+}
 
-	} else if (distMtrSquInt <= dMinL2SquInt) {
-		newAlarmLevel = ALARM_LEVEL_2;
+#if FLIGHT_OBJECT_LIST_GRID == 1
+// Marks f as visited in this prediction. If we haven't visited the flight
+// object in the previous iteration, its current position is outdated; we
+// restart from the rx data.
+static void predictionVisitOther(TOcapContext *ctx, TFlightObjectOther *f)
+{
+	if (f->predictionNr != 0 && f->predictionNr + 1 != ctx->predictionNr) {
+		ocapLogStrInt("FLOBJ-REENTER", f->id);
+		flightObjectOtherActivateRxData(f);
+	}
+	f->predictionNr = ctx->predictionNr;
+}
 
-	} else if (distMtrSquInt <= dMinL1SquInt) {
-		newAlarmLevel = ALARM_LEVEL_1;
+static void predictionSelectOtherFlightObjects(
+	TOcapContext *ctx, TFlightObjectOwn *fOwn)
+{
+	// Without our own flight path, we visit all flight objects.
+	if (fOwn->pos_vel_i_ctr == 0) {
+		flightObjectListSelectAllOthers(ctx);
+		return;
 	}
 
-	if (newAlarmLevel == 0) {
-		return NULL;
+	// Bounding box of our own current and predicted positions ...
+	TFlightPath *ownPath = &ctx->ownFlightPath.pos;
+	TVector min;
+	TVector max;
+	vectorCopy(&min, &fOwn->rxPos);
+	vectorCopy(&max, &min);
+	for (int t = 0; t < T_MAX_SEC; t++) {
+		TVector pos;
+		flightPathExtrapolationGetPathPosition(ownPath, t, &pos);
+		min.x = fminf(min.x, pos.x);
+		min.y = fminf(min.y, pos.y);
+		max.x = fmaxf(max.x, pos.x);
+		max.y = fmaxf(max.y, pos.y);
 	}
 
-//	ocapLogStrInt("OCAP-ALARM-LVL", (int)newAlarmLevel);
+	// ... enlarged by the alarm distance and the distance the other
+	// flight objects can fly.
+	float marginMtr = sqrtf(DIST_MTR_SQU_CHECK_LIMIT) + PREDICTION_GRID_MARGIN_MTR;
+	min.x -= marginMtr;
+	min.y -= marginMtr;
+	max.x += marginMtr;
+	max.y += marginMtr;
 
-	TAlarmState *alarmState = alarmStateListAdd(f, newAlarmLevel, t);
-	return alarmState;
+	flightObjectListSelectOthers(ctx, &min, &max);
 }
+#endif
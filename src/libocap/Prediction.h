@@ -36,9 +36,45 @@
 #define __PREDICTION_H__ 1
 
 #include <inttypes.h>
+#include "OcapContext.h"
 
-void predictionInit(float k, float facLevel2, float facLevel1);
-void predictionCalculateAlarmStates(uint32_t ts);
+void predictionInit(TOcapContext *ctx, float k, float facLevel2, float facLevel1);
+void predictionCalculateAlarmStates(TOcapContext *ctx, uint32_t ts);
+
+// Same as predictionCalculateAlarmStates, and additionally checks the
+// predicted flight paths with the parameters of nofSets other contexts
+// (e.g. for a parameter sweep). The flight paths are only extrapolated once.
+// Each set is a context initialized with ocapContextInitWithMemory and
+// predictionInit; only its parameters, its alarm states and its alarm
+// service are used (its flight object capacity can be 1). The alarm states
+// of a set refer to the flight objects of ctx.
+void predictionCalculateAlarmStatesSweep(
+	TOcapContext *ctx, uint32_t ts, TOcapContext *sets, int nofSets);
+
+// Ground station mode: calculates the alarm states of every other flight
+// object of ctx as if it were our own aircraft, against all other flight
+// objects (our own aircraft isn't used). Needs a context with
+// TOcapCapacities.groundAlarmStates > 0; the alarm states of a flight
+// object are read with groundAlarmListGetCount/-GetAtIndex.
+// The flight path of each flight object is extrapolated once, and each
+// pair that can come close is checked once (in both directions), instead
+// of one context per aircraft which extrapolates all other flight paths.
+void predictionCalculateAlarmStatesGround(TOcapContext *ctx, uint32_t ts);
+
+#if PREDICTION_THREADS_MAX > 1
+// Same as predictionCalculateAlarmStates, with the other flight objects
+// distributed over the threads of the context (including the calling
+// thread, see TOcapCapacities.predictionThreads). The threads wait for
+// the next call between the predictions. The alarm states are identical
+// to the ones of predictionCalculateAlarmStates; only the order of the log
+// output differs. The log functions must be thread-safe.
+void predictionCalculateAlarmStatesParallel(TOcapContext *ctx, uint32_t ts);
+
+// Start and stop the threads of predictionCalculateAlarmStatesParallel.
+// Called by ocapContextInitWithMemory and ocapContextExit.
+void predictionStartThreads(TOcapContext *ctx, int nofThreads);
+void predictionStopThreads(TOcapContext *ctx);
+#endif
 
 #endif // __PREDICTION_H__
 
@@ -0,0 +1,194 @@
+//
+// RxQueue.c
+//
+// OCAP - Open Collision Avoidance Protocol
+//
+// Lock-free queue of received updates of other flight objects.
+//
+// 17.10.2026 ASR  First version.
+//
+// Software License (BSD):
+// Copyright 2026 Classy Code GmbH.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contribu-
+//    tors may be used to endorse or promote products derived from this soft-
+//    ware without specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS “AS IS”
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+
+#include "RxQueue.h"
+#include "CalculateOtherData.h"
+#include "FlightObjectList.h"
+#include "InputRecorder.h"
+#include "OcapLog.h"
+
+// Bounded multi-producer queue (after D. Vyukov): every entry has a
+// sequence number. An entry at position pos is free for a producer if its
+// sequence number is pos, and ready for the consumer if it is pos + 1. A
+// producer reserves a position by incrementing the head with a
+// compare-and-swap, fills the entry and then publishes it by setting the
+// sequence number. The consumer releases an entry for the next round by
+// setting it to pos + length. Positions wrap around at 2^32.
+
+
+static int rxQueuePushEntry(TOcapContext *ctx, uint32_t id, uint32_t ts, int isGlobal,
+	TLocalFrameGlobalPos *curPos, TVector *curVel, TVector *z, EOcapPathModel pathModel);
+
+static void rxQueueApply(TOcapContext *ctx, TRxQueueEntry *e);
+static void rxQueueApplyEntry(TOcapContext *ctx, TRxQueueEntry *e);
+
+
+int rxQueuePush(TOcapContext *ctx, uint32_t id, uint32_t ts,
+	TVector *curPos, TVector *curVel, TVector *z, EOcapPathModel pathModel)
+{
+	TLocalFrameGlobalPos pos;
+	pos.x = curPos->x;
+	pos.y = curPos->y;
+	pos.z = curPos->z;
+	return rxQueuePushEntry(ctx, id, ts, 0, &pos, curVel, z, pathModel);
+}
+
+int rxQueuePushGlobal(TOcapContext *ctx, uint32_t id, uint32_t ts,
+	TLocalFrameGlobalPos *curPos, TVector *curVel, TVector *z, EOcapPathModel pathModel)
+{
+	return rxQueuePushEntry(ctx, id, ts, 1, curPos, curVel, z, pathModel);
+}
+
+int rxQueueDrain(TOcapContext *ctx)
+{
+	// Only the consumer modifies the tail.
+	int n = 0;
+	while (ctx->rxQueue) {
+		uint32_t pos = ctx->rxQueueTail;
+		TRxQueueEntry *e = &ctx->rxQueue[pos & ctx->rxQueueMask];
+		uint32_t seq = __atomic_load_n(&e->seq, __ATOMIC_ACQUIRE);
+		if (seq != pos + 1) {
+			// Empty, or the producer is still filling the entry; the
+			// remaining updates are applied in the next prediction.
+			break;
+		}
+
+		TRxQueueEntry entry = *e;
+		__atomic_store_n(&e->seq, pos + ctx->rxQueueMask + 1, __ATOMIC_RELEASE);
+		ctx->rxQueueTail = pos + 1;
+
+		rxQueueApply(ctx, &entry);
+		n++;
+	}
+	return n;
+}
+
+uint32_t rxQueueGetOverflowCount(TOcapContext *ctx)
+{
+	return __atomic_load_n(&ctx->rxQueueOverflows, __ATOMIC_RELAXED);
+}
+
+uint32_t rxQueueGetRejectedCount(TOcapContext *ctx)
+{
+	return ctx->rxQueueRejected;
+}
+
+void rxQueueInit(TOcapContext *ctx)
+{
+	ctx->rxQueueHead = 0;
+	ctx->rxQueueTail = 0;
+	ctx->rxQueueOverflows = 0;
+	ctx->rxQueueRejected = 0;
+	for (uint32_t i = 0; ctx->rxQueue && i <= ctx->rxQueueMask; i++) {
+		ctx->rxQueue[i].seq = i;
+	}
+}
+
+static int rxQueuePushEntry(TOcapContext *ctx, uint32_t id, uint32_t ts, int isGlobal,
+	TLocalFrameGlobalPos *curPos, TVector *curVel, TVector *z, EOcapPathModel pathModel)
+{
+	if (!ctx->rxQueue) {
+		__atomic_fetch_add(&ctx->rxQueueOverflows, 1, __ATOMIC_RELAXED);
+		return -1;
+	}
+
+	// Reserve an entry.
+	TRxQueueEntry *e;
+	uint32_t pos = __atomic_load_n(&ctx->rxQueueHead, __ATOMIC_RELAXED);
+	for (;;) {
+		e = &ctx->rxQueue[pos & ctx->rxQueueMask];
+		uint32_t seq = __atomic_load_n(&e->seq, __ATOMIC_ACQUIRE);
+		int32_t dif = (int32_t)(seq - pos);
+		if (dif == 0) {
+			// The entry is free; on failure, pos is set to the current head.
+			if (__atomic_compare_exchange_n(&ctx->rxQueueHead, &pos, pos + 1,
+					1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+				break;
+			}
+		} else if (dif < 0) {
+			// The consumer hasn't released the entry yet: full.
+			__atomic_fetch_add(&ctx->rxQueueOverflows, 1, __ATOMIC_RELAXED);
+			return -1;
+		} else {
+			// Another producer has taken the entry.
+			pos = __atomic_load_n(&ctx->rxQueueHead, __ATOMIC_RELAXED);
+		}
+	}
+
+	// Fill and publish the entry.
+	e->id = id;
+	e->ts = ts;
+	e->isGlobal = isGlobal;
+	e->pos = *curPos;
+	vectorCopy(&e->vel, curVel);
+	e->hasZ = z != 0L;
+	if (z) {
+		vectorCopy(&e->z, z);
+	}
+	e->pathModel = pathModel;
+	__atomic_store_n(&e->seq, pos + 1, __ATOMIC_RELEASE);
+	return 0;
+}
+
+// Applies an update to its flight object.
+static void rxQueueApply(TOcapContext *ctx, TRxQueueEntry *e)
+{
+	// Recorded as a whole (the replay queues it again).
+	inputRecorderRecordRx(ctx, e);
+	ctx->inputRecorderSuspended++;
+	rxQueueApplyEntry(ctx, e);
+	ctx->inputRecorderSuspended--;
+}
+
+static void rxQueueApplyEntry(TOcapContext *ctx, TRxQueueEntry *e)
+{
+	TFlightObjectOther *f = flightObjectListGetOther(ctx, e->id);
+	if (!f) {
+		f = flightObjectListAddOther(ctx, e->id);
+	}
+	if (!f) {
+		ocapLogStrInt("RXQUEUE-REJECTED", (int)e->id);
+		ctx->rxQueueRejected++;
+		return;
+	}
+
+	TVector pos;
+	if (e->isGlobal) {
+		localFrameToLocal(&ctx->localFrame, &e->pos, &pos);
+	} else {
+		vectorInit(&pos, (float)e->pos.x, (float)e->pos.y, (float)e->pos.z);
+	}
+	calculateOtherDataFromInfo(ctx, f, e->ts, &pos, &e->vel,
+		e->hasZ ? &e->z : 0L, e->pathModel);
+}
@@ -0,0 +1,78 @@
+//
+// RxQueue.h
+//
+// OCAP - Open Collision Avoidance Protocol
+//
+// Lock-free queue of received updates of other flight objects.
+//
+// 17.10.2026 ASR  First version.
+//
+// Software License (BSD):
+// Copyright 2026 Classy Code GmbH.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contribu-
+//    tors may be used to endorse or promote products derived from this soft-
+//    ware without specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS “AS IS”
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+
+#ifndef __RX_QUEUE_H__
+#define __RX_QUEUE_H__ 1
+
+#include <inttypes.h>
+#include "Vector.h"
+#include "FlightPathExtrapolation.h"
+#include "LocalFrame.h"
+#include "OcapContext.h"
+
+// calculateOtherDataFromInfo modifies the flight objects that the
+// prediction reads, so it must run on the thread of the prediction. With
+// several receivers (threads or interrupt handlers), push the received data
+// into the queue of the context instead. Pushing never blocks and may be
+// called from any number of threads concurrently with the prediction; the
+// prediction applies the queued updates at its start (rxQueueDrain).
+// The queue holds TOcapCapacities.rxQueueLength updates; if it is full,
+// the update is dropped and counted (rxQueueGetOverflowCount).
+
+// Call this method after receiving data on the flight object with the given
+// ID, with the same parameters as calculateOtherDataFromInfo (the center z
+// is optional). Returns 0 on success, -1 if the queue is full.
+int rxQueuePush(TOcapContext *ctx, uint32_t id, uint32_t ts,
+	TVector *curPos, TVector *curVel, TVector *z, EOcapPathModel pathModel);
+
+// Same as rxQueuePush with the position in global coordinates; it is
+// converted into the local frame of the context when the update is applied.
+int rxQueuePushGlobal(TOcapContext *ctx, uint32_t id, uint32_t ts,
+	TLocalFrameGlobalPos *curPos, TVector *curVel, TVector *z, EOcapPathModel pathModel);
+
+// Applies all queued updates with calculateOtherDataFromInfo and adds
+// unknown flight objects to the list. Called by the prediction; must only
+// be called on the thread of the prediction. Returns the number of updates.
+int rxQueueDrain(TOcapContext *ctx);
+
+// Number of updates dropped because the queue was full.
+uint32_t rxQueueGetOverflowCount(TOcapContext *ctx);
+
+// Number of updates dropped because the flight object list was full.
+uint32_t rxQueueGetRejectedCount(TOcapContext *ctx);
+
+// Called by ocapContextInitWithMemory.
+void rxQueueInit(TOcapContext *ctx);
+
+#endif // __RX_QUEUE_H__
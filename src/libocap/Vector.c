@@ -6,6 +6,7 @@
 // A simple 3D vector.
 //
 // 02.07.2024 ASR  First version.
+// 17.10.2026 ASR  Out-of-line wrappers around the inline versions.
 //
 // Software License (BSD):
 // Copyright 2023-2025 Classy Code GmbH.
@@ -32,62 +33,52 @@
 // DAMAGE.
 //
 
+#define VECTOR_OUT_OF_LINE 1
+
 #include "Vector.h"
 
 
 void vectorInit(TVector *target, float x, float y, float z)
 {
-	target->x = x;
-	target->y = y;
-	target->z = z;
+	vectorInitInline(target, x, y, z);
 }
 
 void vectorClear(TVector *target)
 {
-	target->x = 0;
-	target->y = 0;
-	target->z = 0;
+	vectorClearInline(target);
 }
 
 void vectorCopy(TVector *target, TVector *source)
 {
-	target->x = source->x;
-	target->y = source->y;
-	target->z = source->z;
+	vectorCopyInline(target, source);
 }
 
 void vectorAddVector(TVector *target, TVector *source)
 {
-	target->x += source->x;
-	target->y += source->y;
-	target->z += source->z;
+	vectorAddVectorInline(target, source);
 }
 
 void vectorSubtractVector(TVector *target, TVector *source)
 {
-	target->x -= source->x;
-	target->y -= source->y;
-	target->z -= source->z;
+	vectorSubtractVectorInline(target, source);
 }
 
 void vectorMultiplyScalar(TVector *target, float v)
 {
-	target->x *= v;
-	target->y *= v;
-	target->z *= v;
+	vectorMultiplyScalarInline(target, v);
 }
 
 float vectorMultiplyDot(TVector *vec1, TVector *vec2)
 {
-	return vec1->x * vec2->x + vec1->y * vec2->y + vec1->z * vec2->z;
+	return vectorMultiplyDotInline(vec1, vec2);
 }
 
 float vectorGetLength(TVector *target)
 {
-	return sqrt(target->x * target->x + target->y * target->y + target->z * target->z);
+	return vectorGetLengthInline(target);
 }
 
 int vectorEqualsVector(TVector *vec1, TVector *vec2)
 {
-	return (vec1->x == vec2->x) && (vec1->y == vec2->y) && (vec1->z == vec2->z);
+	return vectorEqualsVectorInline(vec1, vec2);
 }
@@ -6,6 +6,7 @@
 // A simple 3D vector.
 //
 // 02.07.2024 ASR  First version.
+// 17.10.2026 ASR  Inline versions of the vector functions.
 //
 // Software License (BSD):
 // Copyright 2023-2025 Classy Code GmbH.
@@ -37,6 +38,8 @@
 
 #include <math.h>
 
+#include "FastMath.h"
+
 typedef struct {
 	float x;
 	float y;
@@ -44,6 +47,16 @@ typedef struct {
 } TVector;
 
 
+// The vector functions are called in every step of the prediction. The
+// library is built without optimization, where a plain "inline" is ignored,
+// so the header versions force inlining. The out-of-line functions in
+// Vector.c remain available for users linking against the symbols.
+#if defined(__GNUC__)
+#define VECTOR_INLINE static inline __attribute__((always_inline))
+#else
+#define VECTOR_INLINE static inline
+#endif
+
 void vectorInit(TVector *target, float x, float y, float z);
 void vectorClear(TVector *target);
 void vectorCopy(TVector *target, TVector *source);
@@ -57,5 +70,77 @@ float vectorMultiplyDot(TVector *vec1, TVector *vec2);
 float vectorGetLength(TVector *target);
 int vectorEqualsVector(TVector *vec1, TVector *vec2);
 
-#endif // __VECTOR_H__
 
+VECTOR_INLINE void vectorInitInline(TVector *target, float x, float y, float z)
+{
+	target->x = x;
+	target->y = y;
+	target->z = z;
+}
+
+VECTOR_INLINE void vectorClearInline(TVector *target)
+{
+	target->x = 0;
+	target->y = 0;
+	target->z = 0;
+}
+
+VECTOR_INLINE void vectorCopyInline(TVector *target, const TVector *source)
+{
+	target->x = source->x;
+	target->y = source->y;
+	target->z = source->z;
+}
+
+VECTOR_INLINE void vectorAddVectorInline(TVector *target, const TVector *source)
+{
+	target->x += source->x;
+	target->y += source->y;
+	target->z += source->z;
+}
+
+VECTOR_INLINE void vectorSubtractVectorInline(TVector *target, const TVector *source)
+{
+	target->x -= source->x;
+	target->y -= source->y;
+	target->z -= source->z;
+}
+
+VECTOR_INLINE void vectorMultiplyScalarInline(TVector *target, float v)
+{
+	target->x *= v;
+	target->y *= v;
+	target->z *= v;
+}
+
+VECTOR_INLINE float vectorMultiplyDotInline(const TVector *vec1, const TVector *vec2)
+{
+	return vec1->x * vec2->x + vec1->y * vec2->y + vec1->z * vec2->z;
+}
+
+VECTOR_INLINE float vectorGetLengthInline(const TVector *target)
+{
+	return fastMathSqrt(target->x * target->x + target->y * target->y + target->z * target->z);
+}
+
+VECTOR_INLINE int vectorEqualsVectorInline(const TVector *vec1, const TVector *vec2)
+{
+	return (vec1->x == vec2->x) && (vec1->y == vec2->y) && (vec1->z == vec2->z);
+}
+
+
+// Route the calls to the inline versions. Vector.c defines
+// VECTOR_OUT_OF_LINE to provide the exported functions.
+#ifndef VECTOR_OUT_OF_LINE
+#define vectorInit(target, x, y, z) vectorInitInline(target, x, y, z)
+#define vectorClear(target) vectorClearInline(target)
+#define vectorCopy(target, source) vectorCopyInline(target, source)
+#define vectorAddVector(target, source) vectorAddVectorInline(target, source)
+#define vectorSubtractVector(target, source) vectorSubtractVectorInline(target, source)
+#define vectorMultiplyScalar(target, v) vectorMultiplyScalarInline(target, v)
+#define vectorMultiplyDot(vec1, vec2) vectorMultiplyDotInline(vec1, vec2)
+#define vectorGetLength(target) vectorGetLengthInline(target)
+#define vectorEqualsVector(vec1, vec2) vectorEqualsVectorInline(vec1, vec2)
+#endif
+
+#endif // __VECTOR_H__
@@ -0,0 +1,190 @@
+//
+// bench_math.cpp
+//
+// OCAP - Open Collision Avoidance Protocol
+//
+// Microbenchmarks and maximum errors of FastMath.c against the C library.
+// Build with "make bench" (optionally DEFS=-DFAST_MATH_NEWTON_STEPS=n)
+// and run it on the target platform.
+//
+// 17.10.2026 ASR  First version.
+//
+// Software License (BSD):
+// Copyright 2026 Classy Code GmbH.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contribu-
+//    tors may be used to endorse or promote products derived from this soft-
+//    ware without specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS “AS IS”
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+
+#include <math.h>
+#include <stdio.h>
+#include <chrono>
+#include "FastMath.h"
+
+#if OCAP_FAST_MATH != 1
+#error "Compile with -DOCAP_FAST_MATH=1, see make bench"
+#endif
+
+typedef float (*TMathFunction)(float x);
+typedef double (*TReferenceFunction)(double x);
+
+typedef struct {
+	const char *name;
+	const char *range;
+	float min;
+	float max;
+	// Distribute the inputs logarithmically (for sqrt) instead of uniformly.
+	int isLogarithmic;
+	// Relative instead of absolute error.
+	int isRelative;
+	TMathFunction library;
+	TMathFunction fast;
+	TReferenceFunction reference;
+} TBenchCase;
+
+static float benchLibrarySin(float x);
+static float benchLibraryCos(float x);
+static float benchLibrarySqrt(float x);
+static float benchLibraryRsqrt(float x);
+static double benchReferenceRsqrt(double x);
+static void benchInitInputs(TBenchCase *bc, float *inputs, int n);
+static double benchGetNsPerCall(TMathFunction f, float *inputs, int n);
+static double benchGetMaxError(TBenchCase *bc, TMathFunction f, float *inputs, int n);
+
+#define BENCH_NOF_INPUTS 4096
+#define BENCH_NOF_REPEATS 2000
+
+static TBenchCase sBenchCases[] = {
+	{ "sin", "|x| <= pi", -M_PI, M_PI, 0, 0, benchLibrarySin, fastMathSin, sin },
+	{ "sin", "0 ... 0.5", 0.0f, 0.5f, 0, 0, benchLibrarySin, fastMathSin, sin },
+	{ "sin", "|x| <= 1000", -1000.0f, 1000.0f, 0, 0, benchLibrarySin, fastMathSin, sin },
+	{ "cos", "|x| <= pi", -M_PI, M_PI, 0, 0, benchLibraryCos, fastMathCos, cos },
+	{ "cos", "0 ... 0.5", 0.0f, 0.5f, 0, 0, benchLibraryCos, fastMathCos, cos },
+	{ "sqrt", "1e-3 ... 1e9", 1e-3f, 1e9f, 1, 1, benchLibrarySqrt, fastMathSqrt, sqrt },
+	{ "rsqrt", "1e-3 ... 1e9", 1e-3f, 1e9f, 1, 1, benchLibraryRsqrt, fastMathRsqrt, benchReferenceRsqrt },
+};
+
+// Keeps the compiler from removing the benchmark loops.
+static volatile float sSink;
+
+
+int main(int argc, char *argv[])
+{
+	static float inputs[BENCH_NOF_INPUTS];
+
+	printf("FAST_MATH_NEWTON_STEPS = %d\n", FAST_MATH_NEWTON_STEPS);
+	printf("%-6s %-13s %12s %12s %14s %14s\n", "func", "range",
+		"library ns", "fast ns", "library error", "fast error");
+	int nofBenchCases = sizeof(sBenchCases) / sizeof(sBenchCases[0]);
+	for (int i = 0; i < nofBenchCases; i++) {
+		TBenchCase *bc = &sBenchCases[i];
+		benchInitInputs(bc, inputs, BENCH_NOF_INPUTS);
+		printf("%-6s %-13s %12.2f %12.2f %10.2e %s %10.2e %s\n", bc->name, bc->range,
+			benchGetNsPerCall(bc->library, inputs, BENCH_NOF_INPUTS),
+			benchGetNsPerCall(bc->fast, inputs, BENCH_NOF_INPUTS),
+			benchGetMaxError(bc, bc->library, inputs, BENCH_NOF_INPUTS),
+			bc->isRelative ? "rel" : "abs",
+			benchGetMaxError(bc, bc->fast, inputs, BENCH_NOF_INPUTS),
+			bc->isRelative ? "rel" : "abs");
+	}
+	return 0;
+}
+
+static float benchLibrarySin(float x)
+{
+	return sinf(x);
+}
+
+static float benchLibraryCos(float x)
+{
+	return cosf(x);
+}
+
+static float benchLibrarySqrt(float x)
+{
+	return sqrtf(x);
+}
+
+static float benchLibraryRsqrt(float x)
+{
+	return 1.0f / sqrtf(x);
+}
+
+static double benchReferenceRsqrt(double x)
+{
+	return 1.0 / sqrt(x);
+}
+
+// Evenly spread inputs in [min, max] (shuffled by a fixed permutation,
+// so that branches can't be predicted from the order).
+static void benchInitInputs(TBenchCase *bc, float *inputs, int n)
+{
+	for (int i = 0; i < n; i++) {
+		int j = (int)((i * 2654435761u) % (uint32_t)n);
+		double f = (double)j / (n - 1);
+		if (bc->isLogarithmic) {
+			inputs[i] = (float)(bc->min * pow((double)bc->max / bc->min, f));
+		} else {
+			inputs[i] = (float)(bc->min + (bc->max - bc->min) * f);
+		}
+	}
+}
+
+static double benchGetNsPerCall(TMathFunction f, float *inputs, int n)
+{
+	auto start = std::chrono::steady_clock::now();
+	float sum = 0;
+	for (int r = 0; r < BENCH_NOF_REPEATS; r++) {
+		for (int i = 0; i < n; i++) {
+			sum += f(inputs[i]);
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+	sSink = sum;
+	double ns = std::chrono::duration<double, std::nano>(end - start).count();
+	return ns / ((double)n * BENCH_NOF_REPEATS);
+}
+
+// Against the double precision result, for the inputs and 2^20 further
+// values in the range.
+static double benchGetMaxError(TBenchCase *bc, TMathFunction f, float *inputs, int n)
+{
+	double maxError = 0;
+	const int nofSteps = 1 << 20;
+	for (int i = 0; i < n + nofSteps; i++) {
+		float x = inputs[i % n];
+		if (i >= n) {
+			double step = (double)(i - n) / (nofSteps - 1);
+			x = bc->isLogarithmic
+				? (float)(bc->min * pow((double)bc->max / bc->min, step))
+				: (float)(bc->min + (bc->max - bc->min) * step);
+		}
+		double expected = bc->reference(x);
+		double error = fabs(f(x) - expected);
+		if (bc->isRelative) {
+			error /= fabs(expected);
+		}
+		if (error > maxError) {
+			maxError = error;
+		}
+	}
+	return maxError;
+}
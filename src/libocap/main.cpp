@@ -1,62 +1,584 @@
+#include <math.h>
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <thread>
+#include <vector>
+#include <string.h>
+#include "AlarmEventQueue.h"
+#include "AlarmService.h"
 #include "AlarmStateList.h"
 #include "FlightObjectList.h"
 #include "FlightObjectOrientation.h"
 #include "FlightPathExtrapolation.h"
+#include "GroundAlarmList.h"
 #include "Prediction.h"
 #include "CalculateOwnData.h"
 #include "CalculateOtherData.h"
+#include "OcapContext.h"
+#include "RxQueue.h"
 
 
+static void testCheck(const char *name, int isOk);
+static uint8_t *testInitContext(TOcapContext *ctx, TOcapCapacities *capacities);
+
 static void testAlarmStateList(void);
+static void testAlarmStateListLarge(void);
+static void testFlightObjectList(void);
+static void testRxQueue(void);
+static void testAlarmEventQueue(void);
+static void testAlarmService(void);
 static void testFlightPathExtrapolation2rv(void);
 static void testFlightPathExtrapolationRvz(void);
+static void testFlightPathExtrapolationAccuracy(void);
+static void testConeCheckSimd(void);
+#if PREDICTION_LINEAR_SOLVER == 1
+static void testConeCheckLinear(void);
+#endif
 static void testPrediction(void);
+static void testPredictionFreshContext(void);
+static void testPredictionGround(void);
+static void testPredictionGlobal(void);
+#if PREDICTION_THREADS_MAX > 1
+static void testPredictionParallel(void);
+#endif
+
+// The library instance used by all tests.
+static TOcapContext sCtx;
+static uint8_t *sCtxMemory;
+
+// Number of failed checks, see testCheck.
+static int sFailureCount;
 
 
 int main(int argc, char *argv[])
 {
 	std::cout << "libocap-test" << std::endl;
 
+	TOcapCapacities capacities;
+	ocapCapacitiesInitDefault(&capacities);
+	sCtxMemory = testInitContext(&sCtx, &capacities);
+
 	testAlarmStateList();
+	testAlarmStateListLarge();
+	testFlightObjectList();
+	testRxQueue();
+	testAlarmEventQueue();
+	testAlarmService();
 
 	testFlightPathExtrapolation2rv();
 	testFlightPathExtrapolationRvz();
+	testFlightPathExtrapolationAccuracy();
+	testConeCheckSimd();
+#if PREDICTION_LINEAR_SOLVER == 1
+	testConeCheckLinear();
+#endif
 
 	testPrediction();
+	testPredictionFreshContext();
+	testPredictionGround();
+	testPredictionGlobal();
+#if PREDICTION_THREADS_MAX > 1
+	testPredictionParallel();
+#endif
+
+	ocapContextExit(&sCtx);
+	delete[] sCtxMemory;
+	return sFailureCount ? 1 : 0;
+}
 
-	return 0;
+static void testCheck(const char *name, int isOk)
+{
+	printf("    %s: %s\n", name, isOk ? "OK" : "FAILED");
+	if (!isOk) {
+		sFailureCount++;
+	}
+}
+
+static uint8_t *testInitContext(TOcapContext *ctx, TOcapCapacities *capacities)
+{
+	size_t memorySize = ocapContextGetMemorySize(capacities);
+	uint8_t *memory = new uint8_t[memorySize];
+	ocapContextInitWithMemory(ctx, capacities, memory, memorySize);
+	return memory;
 }
 
 static void testAlarmStateList(void)
 {
-	alarmStateListClear();
+	alarmStateListClear(&sCtx);
+
+	TFlightObjectOther *f1 = flightObjectListAddOther(&sCtx, 0x1);
+	alarmStateListAdd(&sCtx, f1, ALARM_LEVEL_2, 15);
+	alarmStateListDump(&sCtx);
+
+	TFlightObjectOther *f2 = flightObjectListAddOther(&sCtx, 0x2);
+	alarmStateListAdd(&sCtx, f2, ALARM_LEVEL_3, 7);
+	alarmStateListDump(&sCtx);
+
+	TFlightObjectOther *f3 = flightObjectListAddOther(&sCtx, 0x3);
+	alarmStateListAdd(&sCtx, f3, ALARM_LEVEL_1, 18);
+	alarmStateListDump(&sCtx);
+
+	TFlightObjectOther *f4 = flightObjectListAddOther(&sCtx, 0x4);
+	alarmStateListAdd(&sCtx, f4, ALARM_LEVEL_3, 5);
+	alarmStateListDump(&sCtx);
+
+	TFlightObjectOther *f5 = flightObjectListAddOther(&sCtx, 0x5);
+	alarmStateListAdd(&sCtx, f5, ALARM_LEVEL_1, 11);
+	alarmStateListDump(&sCtx);
+
+	TFlightObjectOther *f6 = flightObjectListAddOther(&sCtx, 0x6);
+	alarmStateListAdd(&sCtx, f6, ALARM_LEVEL_2, 9);
+	alarmStateListDump(&sCtx);
+
+	flightObjectListInit(&sCtx, 0);
+}
+
+// Alarm state of the reference model of testAlarmStateListLarge.
+typedef struct {
+	TFlightObjectOther *f;
+	EAlarmLevel level;
+	int timeToEncounterSec;
+	int seq;
+} TTestAlarm;
+
+// Returns 1 if a1 is less critical than a2: the lower priority, or the
+// later insertion with the same priority.
+static bool testAlarmIsLess(const TTestAlarm &a1, const TTestAlarm &a2)
+{
+	int prio1 = ALARM_STATE_PRIO(a1.level, a1.timeToEncounterSec);
+	int prio2 = ALARM_STATE_PRIO(a2.level, a2.timeToEncounterSec);
+	return prio1 != prio2 ? prio1 < prio2 : a1.seq > a2.seq;
+}
+
+// Adds an alarm state to the list and to the reference model, which keeps
+// the capacity most critical ones with a linear search.
+static void testAlarmAdd(TOcapContext *ctx, std::vector<TTestAlarm> &model, int *nextSeq,
+	TFlightObjectOther *f, EAlarmLevel l, int timeToEncounterSec)
+{
+	alarmStateListAdd(ctx, f, l, timeToEncounterSec);
+
+	TTestAlarm a = { f, l, timeToEncounterSec, 0 };
+	for (TTestAlarm &m : model) {
+		if (m.f == f) {
+			if (ALARM_STATE_PRIO(l, timeToEncounterSec)
+					> ALARM_STATE_PRIO(m.level, m.timeToEncounterSec)) {
+				m.level = l;
+				m.timeToEncounterSec = timeToEncounterSec;
+			}
+			return;
+		}
+	}
+	if ((int)model.size() < ctx->alarmStateCapacity) {
+		a.seq = (*nextSeq)++;
+		model.push_back(a);
+		return;
+	}
+	int lowest = 0;
+	for (int i = 1; i < (int)model.size(); i++) {
+		if (testAlarmIsLess(model[i], model[lowest])) {
+			lowest = i;
+		}
+	}
+	if (ALARM_STATE_PRIO(model[lowest].level, model[lowest].timeToEncounterSec)
+			> ALARM_STATE_PRIO(l, timeToEncounterSec)) {
+		return;
+	}
+	a.seq = (*nextSeq)++;
+	model[lowest] = a;
+}
+
+// Returns 1 if the list has the alarm states of the model, most critical first.
+static int testAlarmListEquals(TOcapContext *ctx, std::vector<TTestAlarm> model)
+{
+	std::sort(model.begin(), model.end(),
+		[](const TTestAlarm &a1, const TTestAlarm &a2) { return testAlarmIsLess(a2, a1); });
+	int isEqual = alarmStateListGetCount(ctx) == (int)model.size();
+	for (int i = 0; isEqual && i < (int)model.size(); i++) {
+		TAlarmState *a = alarmStateListGetAtIndex(ctx, i);
+		isEqual = a->flightObject == model[i].f && a->level == model[i].level
+			&& a->timeToEncounterSec == model[i].timeToEncounterSec;
+	}
+	return isEqual;
+}
+
+static void testAlarmStateListLarge(void)
+{
+	printf("testAlarmStateListLarge\n");
+
+	const int nofAlarms = 300;
+	const int nofFlightObjects = 1000;
+	static TOcapContext ctx;
+	TOcapCapacities capacities;
+	ocapCapacitiesInitDefault(&capacities);
+	capacities.flightObjects = nofFlightObjects;
+	capacities.alarmStates = nofAlarms;
+	uint8_t *memory = testInitContext(&ctx, &capacities);
+	flightObjectListInit(&ctx, 1);
+	TFlightObjectOther *f[nofFlightObjects];
+	for (int i = 0; i < nofFlightObjects; i++) {
+		f[i] = flightObjectListAddOther(&ctx, 0x1000 + i);
+	}
+
+	// Few distinct priorities, so that most alarm states are ordered by
+	// their insertion (alarmStateSeq).
+	std::vector<TTestAlarm> model;
+	int nextSeq = 0;
+	uint32_t rnd = 1;
+	alarmStateListClear(&ctx);
+	for (int i = 0; i < nofAlarms; i++) {
+		rnd = rnd * 1103515245u + 12345u;
+		testAlarmAdd(&ctx, model, &nextSeq, f[i],
+			(EAlarmLevel)(1 + (rnd >> 16) % 3), 10 + (rnd >> 20) % 4);
+	}
+	testCheck("ties in insertion order", testAlarmListEquals(&ctx, model));
+
+	// The full list replaces its least critical alarm state (the root of the
+	// heap) or rejects the new one; known flight objects are updated.
+	for (int i = 0; i < 3 * nofFlightObjects; i++) {
+		rnd = rnd * 1103515245u + 12345u;
+		testAlarmAdd(&ctx, model, &nextSeq, f[(rnd >> 8) % nofFlightObjects],
+			(EAlarmLevel)(1 + (rnd >> 16) % 3), 10 + (rnd >> 20) % 4);
+	}
+	testCheck("full list replaces the root", alarmStateListGetCount(&ctx) == nofAlarms
+		&& testAlarmListEquals(&ctx, model));
+
+	// With equal priorities, a new alarm state replaces the last inserted
+	// one (the least critical), so the first ones are kept.
+	model.clear();
+	nextSeq = 0;
+	alarmStateListClear(&ctx);
+	for (int i = 0; i < nofAlarms + 10; i++) {
+		testAlarmAdd(&ctx, model, &nextSeq, f[nofFlightObjects - 1 - i], ALARM_LEVEL_1, 12);
+	}
+	testCheck("equal priority replaces the root", testAlarmListEquals(&ctx, model)
+		&& alarmStateListGetAtIndex(&ctx, nofAlarms - 1)->flightObject
+			== f[nofFlightObjects - nofAlarms - 10]);
+
+	ocapContextExit(&ctx);
+	delete[] memory;
+}
+
+// Home position of the ID in the hash index, as in FlightObjectList.c.
+static int testGetIndexHome(TOcapContext *ctx, uint32_t id)
+{
+	return (int)((id * 2654435769u) >> 16) & ctx->flightObjectIndexMask;
+}
+
+static void testFlightObjectList(void)
+{
+	printf("testFlightObjectList\n");
 
-	TFlightObjectOther *f1 = flightObjectListAddOther(0x1);
-	alarmStateListAdd(f1, ALARM_LEVEL_2, 15);
-	alarmStateListDump();
+	static TOcapContext ctx;
+	TOcapCapacities capacities;
+	ocapCapacitiesInitDefault(&capacities);
+	capacities.flightObjects = 8;
+	uint8_t *memory = testInitContext(&ctx, &capacities);
 
-	TFlightObjectOther *f2 = flightObjectListAddOther(0x2);
-	alarmStateListAdd(f2, ALARM_LEVEL_3, 7);
-	alarmStateListDump();
+	// The slots have handles right after the context init.
+	TFlightObjectOther *f0 = flightObjectListAddOther(&ctx, 0x50);
+	TFlightObjectHandle handle0 = flightObjectListGetOtherHandle(f0);
+	testCheck("handle after context init", handle0 != 0
+		&& flightObjectListGetOtherByHandle(&ctx, handle0) == f0);
+	flightObjectListInit(&ctx, 1);
 
-	TFlightObjectOther *f3 = flightObjectListAddOther(0x3);
-	alarmStateListAdd(f3, ALARM_LEVEL_1, 18);
-	alarmStateListDump();
+	// A handle becomes stale when its flight object is removed, and stays
+	// stale when the slot is reused.
+	TFlightObjectOther *f = flightObjectListAddOther(&ctx, 0x100);
+	TFlightObjectHandle handle = flightObjectListGetOtherHandle(f);
+	testCheck("handle valid", flightObjectListGetOtherByHandle(&ctx, handle) == f);
+	flightObjectListRemoveOtherAtIndex(&ctx, (int)(f - ctx.flightObjects));
+	testCheck("handle removed", flightObjectListGetOtherByHandle(&ctx, handle) == 0L);
+	TFlightObjectOther *g = flightObjectListAddOther(&ctx, 0x200);
+	testCheck("slot reused", g == f);
+	testCheck("handle reused slot", flightObjectListGetOtherByHandle(&ctx, handle) == 0L);
+	testCheck("handle new object", flightObjectListGetOtherByHandle(
+		&ctx, flightObjectListGetOtherHandle(g)) == g);
+	testCheck("ID removed", flightObjectListGetOther(&ctx, 0x100) == 0L);
+	testCheck("ID new object", flightObjectListGetOther(&ctx, 0x200) == g);
 
-	TFlightObjectOther *f4 = flightObjectListAddOther(0x4);
-	alarmStateListAdd(f4, ALARM_LEVEL_3, 5);
-	alarmStateListDump();
+	// Probe chain of 3 IDs with the same home position, followed by an ID
+	// with the next home position (placed behind the chain). Removing from
+	// the chain must keep the others reachable without tombstones.
+	flightObjectListInit(&ctx, 1);
+	uint32_t ids[4];
+	ids[0] = 0x1000;
+	int home = testGetIndexHome(&ctx, ids[0]);
+	int n = 1;
+	for (uint32_t id = ids[0] + 1; n < 3; id++) {
+		if (testGetIndexHome(&ctx, id) == home) {
+			ids[n++] = id;
+		}
+	}
+	for (uint32_t id = ids[0] + 1; n < 4; id++) {
+		if (testGetIndexHome(&ctx, id) == ((home + 1) & ctx.flightObjectIndexMask)) {
+			ids[n++] = id;
+		}
+	}
+	for (int i = 0; i < 4; i++) {
+		flightObjectListAddOther(&ctx, ids[i]);
+	}
+	// Remove the head of the chain, then the (moved) new head.
+	int isFound = 1;
+	for (int removed = 0; removed < 2; removed++) {
+		TFlightObjectOther *r = flightObjectListGetOther(&ctx, ids[removed]);
+		if (!r) {
+			isFound = 0;
+			break;
+		}
+		flightObjectListRemoveOtherAtIndex(&ctx, (int)(r - ctx.flightObjects));
+		for (int i = 0; i < 4; i++) {
+			TFlightObjectOther *o = flightObjectListGetOther(&ctx, ids[i]);
+			isFound &= i <= removed ? o == 0L : o != 0L && o->id == ids[i];
+		}
+	}
+	testCheck("lookup after removal in probe chain", isFound);
 
-	TFlightObjectOther *f5 = flightObjectListAddOther(0x5);
-	alarmStateListAdd(f5, ALARM_LEVEL_1, 11);
-	alarmStateListDump();
+	// Add and remove at full capacity.
+	flightObjectListInit(&ctx, 1);
+	for (int i = 0; i < 8; i++) {
+		flightObjectListAddOther(&ctx, 0x2000 + i);
+	}
+	testCheck("add to full list", flightObjectListAddOther(&ctx, 0x3000) == 0L);
+	flightObjectListRemoveOtherAtIndex(&ctx, 3);
+	flightObjectListRemoveOtherAtIndex(&ctx, 5);
+	TFlightObjectOther *a = flightObjectListAddOther(&ctx, 0x3000);
+	TFlightObjectOther *b = flightObjectListAddOther(&ctx, 0x3001);
+	testCheck("add after removal", a == &ctx.flightObjects[5] && b == &ctx.flightObjects[3]);
+	testCheck("add to full list again", flightObjectListAddOther(&ctx, 0x3002) == 0L);
+	int isFull = flightObjectListGetOtherCount(&ctx) == 8;
+	for (int i = 0; i < 8; i++) {
+		uint32_t id = i == 3 ? 0x3001 : i == 5 ? 0x3000 : 0x2000 + i;
+		isFull &= flightObjectListGetOther(&ctx, id) == &ctx.flightObjects[i];
+	}
+	isFull &= flightObjectListGetOther(&ctx, 0x2003) == 0L
+		&& flightObjectListGetOther(&ctx, 0x2005) == 0L
+		&& flightObjectListGetOther(&ctx, 0x3002) == 0L;
+	testCheck("lookup in full list", isFull);
+
+	delete[] memory;
+}
+
+static void testRxQueue(void)
+{
+	printf("testRxQueue\n");
+
+	const int nofProducers = 4;
+	const int nofPushes = 8;
+	const int nofRounds = 8;
+	static TOcapContext ctx;
+	TOcapCapacities capacities;
+	ocapCapacitiesInitDefault(&capacities);
+	capacities.flightObjects = 256;
+	capacities.rxQueueLength = 16;
+	uint8_t *memory = testInitContext(&ctx, &capacities);
+	flightObjectListInit(&ctx, 1);
+
+	// Start shortly before the positions wrap around at 2^32, as if
+	// 2^32 - 24 updates had been pushed and drained.
+	uint32_t start = 0u - 24;
+	ctx.rxQueueHead = start;
+	ctx.rxQueueTail = start;
+	for (uint32_t pos = start; pos != start + ctx.rxQueueMask + 1; pos++) {
+		ctx.rxQueue[pos & ctx.rxQueueMask].seq = pos;
+	}
+
+	// In each round, the producers push twice as many updates as the queue
+	// holds at the same time, each with its own flight object ID; then the
+	// prediction drains the queue. Every update is either applied (its
+	// flight object exists) or counted as overflow.
+	int nofAccepted = 0;
+	int nofApplied = 0;
+	int isApplied = 1;
+	for (int round = 0; round < nofRounds; round++) {
+		std::atomic<int> isStarted(0);
+		int accepted[nofProducers][nofPushes];
+		std::thread producers[nofProducers];
+		for (int p = 0; p < nofProducers; p++) {
+			producers[p] = std::thread([&, p]() {
+				while (!isStarted.load()) {
+				}
+				for (int k = 0; k < nofPushes; k++) {
+					TVector pos;
+					TVector vel;
+					vectorInit(&pos, 100 * p, 100 * k, 0);
+					vectorInit(&vel, 0, 20, 0);
+					uint32_t id = 1000 * round + 100 * p + k;
+					accepted[p][k] = rxQueuePush(&ctx, id, 1, &pos, &vel, 0L,
+						OCAP_PATH_MODEL_LINEAR) == 0;
+				}
+			});
+		}
+		isStarted.store(1);
+		for (int p = 0; p < nofProducers; p++) {
+			producers[p].join();
+		}
+
+		nofApplied += rxQueueDrain(&ctx);
+		for (int p = 0; p < nofProducers; p++) {
+			for (int k = 0; k < nofPushes; k++) {
+				uint32_t id = 1000 * round + 100 * p + k;
+				isApplied &= (flightObjectListGetOther(&ctx, id) != 0L) == accepted[p][k];
+				nofAccepted += accepted[p][k];
+			}
+		}
+	}
 
-	TFlightObjectOther *f6 = flightObjectListAddOther(0x6);
-	alarmStateListAdd(f6, ALARM_LEVEL_2, 9);
-	alarmStateListDump();
+	int nofPushed = nofRounds * nofProducers * nofPushes;
+	testCheck("queue full in each round", nofApplied == nofRounds * 16);
+	testCheck("accepted updates applied", isApplied && nofApplied == nofAccepted
+		&& flightObjectListGetOtherCount(&ctx) == nofApplied);
+	testCheck("applied or overflow", nofApplied + (int)rxQueueGetOverflowCount(&ctx) == nofPushed
+		&& rxQueueGetRejectedCount(&ctx) == 0);
+	testCheck("wrapped around", ctx.rxQueueTail == start + (uint32_t)nofApplied
+		&& ctx.rxQueueTail < start);
+
+	ocapContextExit(&ctx);
+	delete[] memory;
+}
+
+// Adds an alarm state as the prediction does, with a distance of 100m.
+static void testAddAlarm(TOcapContext *ctx, TFlightObjectOther *f, EAlarmLevel l,
+	int timeToEncounterSec)
+{
+	TAlarmState *a = alarmStateListAdd(ctx, f, l, timeToEncounterSec);
+	vectorInit(&a->curDistanceToFlightObject, 0, 100, 0);
+}
+
+// Returns 1 if the next event of the queue has the given values.
+static int testPopEvent(TOcapContext *ctx, EAlarmEventType type, uint32_t id,
+	EAlarmLevel level, EAlarmLevel previousLevel)
+{
+	TAlarmEvent e;
+	return alarmEventQueuePop(ctx, &e) && e.type == type && e.id == id
+		&& e.level == level && e.previousLevel == previousLevel;
+}
+
+static void testAlarmEventQueue(void)
+{
+	printf("testAlarmEventQueue\n");
+
+	static TOcapContext ctx;
+	TOcapCapacities capacities;
+	ocapCapacitiesInitDefault(&capacities);
+	capacities.flightObjects = 8;
+	capacities.alarmEventQueueLength = 4;
+	uint8_t *memory = testInitContext(&ctx, &capacities);
+	flightObjectListInit(&ctx, 1);
+	TAlarmEvent e;
+
+	// Raised: the most critical first.
+	TFlightObjectOther *a = flightObjectListAddOther(&ctx, 0x10);
+	TFlightObjectOther *b = flightObjectListAddOther(&ctx, 0x20);
+	alarmStateListClear(&ctx);
+	testAddAlarm(&ctx, a, ALARM_LEVEL_1, 20);
+	testAddAlarm(&ctx, b, ALARM_LEVEL_3, 5);
+	alarmEventQueueUpdate(&ctx, 1);
+	int isOk = testPopEvent(&ctx, ALARM_EVENT_RAISED, 0x20, ALARM_LEVEL_3, ALARM_LEVEL_NONE);
+	isOk &= testPopEvent(&ctx, ALARM_EVENT_RAISED, 0x10, ALARM_LEVEL_1, ALARM_LEVEL_NONE);
+	testCheck("raised", isOk && !alarmEventQueuePop(&ctx, &e));
+
+	// Escalated and de-escalated; an unchanged level has no event.
+	alarmStateListClear(&ctx);
+	testAddAlarm(&ctx, a, ALARM_LEVEL_2, 10);
+	testAddAlarm(&ctx, b, ALARM_LEVEL_2, 8);
+	alarmEventQueueUpdate(&ctx, 2);
+	isOk = testPopEvent(&ctx, ALARM_EVENT_DEESCALATED, 0x20, ALARM_LEVEL_2, ALARM_LEVEL_3);
+	isOk &= testPopEvent(&ctx, ALARM_EVENT_ESCALATED, 0x10, ALARM_LEVEL_2, ALARM_LEVEL_1);
+	testCheck("escalated and de-escalated", isOk && !alarmEventQueuePop(&ctx, &e));
+
+	// Cleared: no alarm state in this prediction.
+	alarmStateListClear(&ctx);
+	testAddAlarm(&ctx, b, ALARM_LEVEL_2, 7);
+	alarmEventQueueUpdate(&ctx, 3);
+	isOk = alarmEventQueuePop(&ctx, &e) && e.type == ALARM_EVENT_CLEARED && e.id == 0x10
+		&& e.level == ALARM_LEVEL_NONE && e.previousLevel == ALARM_LEVEL_2
+		&& e.timeToEncounterSec == -1 && e.distMtr >= 0;
+	testCheck("cleared", isOk && !alarmEventQueuePop(&ctx, &e));
+
+	// The slot of b is reused by c before the next prediction: b is cleared
+	// (without distance, as it's released), then c is raised.
+	flightObjectListRemoveOtherAtIndex(&ctx, (int)(b - ctx.flightObjects));
+	TFlightObjectOther *c = flightObjectListAddOther(&ctx, 0x30);
+	testCheck("slot reused", c == b);
+	alarmStateListClear(&ctx);
+	testAddAlarm(&ctx, c, ALARM_LEVEL_1, 15);
+	alarmEventQueueUpdate(&ctx, 4);
+	isOk = alarmEventQueuePop(&ctx, &e) && e.type == ALARM_EVENT_CLEARED && e.id == 0x20
+		&& e.previousLevel == ALARM_LEVEL_2 && e.distMtr == -1;
+	isOk &= testPopEvent(&ctx, ALARM_EVENT_RAISED, 0x30, ALARM_LEVEL_1, ALARM_LEVEL_NONE);
+	testCheck("slot reused by new handle", isOk && !alarmEventQueuePop(&ctx, &e));
+
+	// Overflow: 6 changes don't fit into the queue of 4 events. The
+	// remaining ones are queued after the next prediction.
+	TFlightObjectOther *others[5];
+	alarmStateListClear(&ctx);
+	for (int i = 0; i < 5; i++) {
+		others[i] = flightObjectListAddOther(&ctx, 0x40 + i);
+		testAddAlarm(&ctx, others[i], ALARM_LEVEL_3, 10 + i);
+	}
+	alarmEventQueueUpdate(&ctx, 5);
+	isOk = alarmEventQueueGetOverflowCount(&ctx) == 2;
+	for (int i = 0; i < 4; i++) {
+		isOk &= testPopEvent(&ctx, ALARM_EVENT_RAISED, 0x40 + i, ALARM_LEVEL_3, ALARM_LEVEL_NONE);
+	}
+	testCheck("overflow", isOk && !alarmEventQueuePop(&ctx, &e));
+
+	alarmStateListClear(&ctx);
+	for (int i = 0; i < 5; i++) {
+		testAddAlarm(&ctx, others[i], ALARM_LEVEL_3, 9 + i);
+	}
+	alarmEventQueueUpdate(&ctx, 6);
+	isOk = testPopEvent(&ctx, ALARM_EVENT_RAISED, 0x44, ALARM_LEVEL_3, ALARM_LEVEL_NONE);
+	isOk &= testPopEvent(&ctx, ALARM_EVENT_CLEARED, 0x30, ALARM_LEVEL_NONE, ALARM_LEVEL_1);
+	testCheck("overflow retried", isOk && !alarmEventQueuePop(&ctx, &e)
+		&& alarmEventQueueGetOverflowCount(&ctx) == 2);
 
-	flightObjectListInit(0);
+	ocapContextExit(&ctx);
+	delete[] memory;
+}
+
+static void testAlarmService(void)
+{
+	printf("testAlarmService\n");
+
+	static TOcapContext ctx;
+	TOcapCapacities capacities;
+	ocapCapacitiesInitDefault(&capacities);
+	capacities.flightObjects = 8;
+	capacities.alarmServiceEntries = 2;
+	uint8_t *memory = testInitContext(&ctx, &capacities);
+	flightObjectListInit(&ctx, 1);
+	TFlightObjectOther *a = flightObjectListAddOther(&ctx, 0x10);
+	TFlightObjectOther *b = flightObjectListAddOther(&ctx, 0x20);
+	TFlightObjectOther *c = flightObjectListAddOther(&ctx, 0x30);
+	TFlightObjectOther *d = flightObjectListAddOther(&ctx, 0x40);
+
+	alarmStateListClear(&ctx);
+	testAddAlarm(&ctx, a, ALARM_LEVEL_3, 5);
+	testAddAlarm(&ctx, b, ALARM_LEVEL_1, 20);
+	alarmServiceUpdate(&ctx);
+	testCheck("entries added", alarmServiceGetCount(&ctx) == 2);
+
+	// The full table replaces the entry with the lowest level (b).
+	alarmStateListClear(&ctx);
+	testAddAlarm(&ctx, c, ALARM_LEVEL_2, 10);
+	alarmServiceUpdate(&ctx);
+	testCheck("lowest entry replaced", alarmServiceGetCount(&ctx) == 2
+		&& alarmServiceGetByHandle(&ctx, flightObjectListGetOtherHandle(a)) != 0L
+		&& alarmServiceGetByHandle(&ctx, flightObjectListGetOtherHandle(b)) == 0L
+		&& alarmServiceGetByHandle(&ctx, flightObjectListGetOtherHandle(c)) != 0L);
+
+	// Not if all entries have a higher level than the new one.
+	alarmStateListClear(&ctx);
+	testAddAlarm(&ctx, d, ALARM_LEVEL_1, 10);
+	alarmServiceUpdate(&ctx);
+	testCheck("higher entries kept", alarmServiceGetByHandle(&ctx, flightObjectListGetOtherHandle(d)) == 0L
+		&& alarmServiceGetByHandle(&ctx, flightObjectListGetOtherHandle(a)) != 0L
+		&& alarmServiceGetByHandle(&ctx, flightObjectListGetOtherHandle(c)) != 0L);
+
+	ocapContextExit(&ctx);
+	delete[] memory;
 }
 
 static void testFlightPathExtrapolation2rv(void)
@@ -71,6 +593,7 @@ static void testFlightPathExtrapolation2rv(void)
 	TVector v1_vec = { 0.19632, 0.56697, 0.0};
 
 	TFlightPathExtrapolationData fpe;
+	memset(&fpe, 0, sizeof(fpe));
 
 	vectorCopy(&fpe.r0_vec, &r0_vec);
 	vectorCopy(&fpe.v0_vec, &v0_vec);
@@ -107,12 +630,14 @@ static void testFlightPathExtrapolationRvz(void)
 	TVector z_vec =  { 1.8, 0.0, 0.0 };
 
 	TFlightPathExtrapolationData fpe;
+	memset(&fpe, 0, sizeof(fpe));
 
 	vectorCopy(&fpe.r0_vec, &r0_vec);
 	vectorCopy(&fpe.v0_vec, &v0_vec);
 	vectorCopy(&fpe.ri_vec, &r0_vec);
 	vectorCopy(&fpe.vi_vec, &v0_vec);
 	vectorCopy(&fpe.z_vec, &z_vec);
+	fpe.predictionModel = OCAP_PATH_MODEL_ARC;
 
 	// Initialization step.
 
@@ -134,6 +659,135 @@ static void testFlightPathExtrapolationRvz(void)
 	}
 }
 
+// Pseudo random number in [min, max), from the state *rnd.
+static float testRandom(uint32_t *rnd, float min, float max)
+{
+	*rnd = *rnd * 1103515245u + 12345u;
+	return min + (max - min) * (float)((*rnd >> 8) & 0xffff) / 65536.0f;
+}
+
+// Random straight-line encounter: our own path in own and the other
+// aircraft in fpe (LINEAR), which passes our path at a random time with
+// a random miss distance, as seen from t = startSec + 1 of fpe.
+static void testRandomLinearEncounter(uint32_t *rnd, TConeCheckOwn *own, TVector *ownVel,
+	TFlightPathExtrapolationData *fpe, int32_t startSec, float *vOtherMsSqu)
+{
+	float heading = testRandom(rnd, 0, 6.2832f);
+	float speed = testRandom(rnd, 15, 70);
+	TVector ownPos;
+	vectorInit(&ownPos, testRandom(rnd, -3000, 3000), testRandom(rnd, -3000, 3000),
+		testRandom(rnd, 0, 2000));
+	vectorInit(ownVel, speed * cos(heading), speed * sin(heading), testRandom(rnd, -3, 3));
+	for (int t = 0; t < T_MAX_SEC; t++) {
+		TVector pos;
+		vectorInit(&pos, ownPos.x + t * ownVel->x, ownPos.y + t * ownVel->y,
+			ownPos.z + t * ownVel->z);
+		coneCheckSetOwn(own, 30, t, &pos, ownVel);
+	}
+
+	heading = testRandom(rnd, 0, 6.2832f);
+	speed = testRandom(rnd, 0, 70);
+	float tEncounter = testRandom(rnd, -10, 50);
+	TVector otherVel;
+	vectorInit(&otherVel, speed * cos(heading), speed * sin(heading), testRandom(rnd, -3, 3));
+	*fpe = {};
+	vectorInit(&fpe->ri_vec,
+		ownPos.x + tEncounter * (ownVel->x - otherVel.x) - (startSec + 1) * otherVel.x
+			+ testRandom(rnd, -1000, 1000),
+		ownPos.y + tEncounter * (ownVel->y - otherVel.y) - (startSec + 1) * otherVel.y
+			+ testRandom(rnd, -1000, 1000),
+		ownPos.z + tEncounter * (ownVel->z - otherVel.z) - (startSec + 1) * otherVel.z
+			+ testRandom(rnd, -100, 100));
+	vectorCopy(&fpe->vi_vec, &otherVel);
+	vectorCopy(&fpe->r0_vec, &fpe->ri_vec);
+	vectorCopy(&fpe->v0_vec, &fpe->vi_vec);
+	fpe->predictionModel = OCAP_PATH_MODEL_LINEAR;
+	flightPathExtrapolationPrepareRvz(fpe);
+	*vOtherMsSqu = otherVel.x * otherVel.x + otherVel.y * otherVel.y + otherVel.z * otherVel.z;
+}
+
+// The kernel selected by CONE_CHECK_SIMD (SSE2, or AVX2 with "make
+// test-avx2") gives exactly the result of the scalar one. The distances
+// go beyond DIST_MTR_SQU_CHECK_LIMIT and the int32 range of the squares;
+// the padding of the other path isn't cleared.
+static void testConeCheckSimd(void)
+{
+	printf("testConeCheckSimd\n");
+
+	static TConeCheckOwn own;
+	static TFlightPath otherPath;
+	static const float scales[] = { 30, 300, 3000, 100000 };
+	uint32_t rnd = 815;
+	int nofLevels[ALARM_LEVEL_3 + 1] = {};
+	int isEqual = 1;
+	for (int i = 0; i < 1000; i++) {
+		float scale = scales[i % 4];
+		for (int t = 0; t < T_MAX_SEC; t++) {
+			TVector pos;
+			TVector vel;
+			vectorInit(&pos, testRandom(&rnd, -500, 500), testRandom(&rnd, -500, 500),
+				testRandom(&rnd, 0, 2000));
+			vectorInit(&vel, testRandom(&rnd, -70, 70), testRandom(&rnd, -70, 70),
+				testRandom(&rnd, -3, 3));
+			coneCheckSetOwn(&own, 30, t, &pos, &vel);
+			otherPath.x[t] = pos.x + testRandom(&rnd, -scale, scale);
+			otherPath.y[t] = pos.y + testRandom(&rnd, -scale, scale);
+			otherPath.z[t] = pos.z + testRandom(&rnd, -scale, scale) * 0.1f;
+		}
+		for (int t = T_MAX_SEC; t < FLIGHT_PATH_LENGTH; t++) {
+			otherPath.x[t] = testRandom(&rnd, -scale, scale);
+			otherPath.y[t] = testRandom(&rnd, -scale, scale);
+			otherPath.z[t] = testRandom(&rnd, -scale, scale);
+		}
+		float vOtherMsSqu = testRandom(&rnd, 0, 5000);
+
+		int t;
+		int tScalar;
+		EAlarmLevel level = coneCheckCalculate(&own, &otherPath, vOtherMsSqu, 2, 3, &t);
+		EAlarmLevel levelScalar = coneCheckCalculateScalar(&own, &otherPath, vOtherMsSqu,
+			2, 3, &tScalar);
+		isEqual &= level == levelScalar && t == tScalar;
+		nofLevels[level]++;
+	}
+	printf("    levels 0/1/2/3: %d/%d/%d/%d\n",
+		nofLevels[0], nofLevels[1], nofLevels[2], nofLevels[3]);
+	testCheck("SIMD equals scalar", isEqual);
+}
+
+#if PREDICTION_LINEAR_SOLVER == 1
+// The solver for straight flight paths (coneCheckCalculateLinear) gives
+// the same level and time as the check of all samples (coneCheckCalculate).
+static void testConeCheckLinear(void)
+{
+	printf("testConeCheckLinear\n");
+
+	static TConeCheckOwn own;
+	static TFlightPath otherPath;
+	uint32_t rnd = 4711;
+	int nofLevels[ALARM_LEVEL_3 + 1] = {};
+	int isEqual = 1;
+	for (int i = 0; i < 400; i++) {
+		TVector ownVel;
+		TFlightPathExtrapolationData fpe;
+		float vOtherMsSqu;
+		int32_t startSec = i % 3;
+		testRandomLinearEncounter(&rnd, &own, &ownVel, &fpe, startSec, &vOtherMsSqu);
+		flightPathExtrapolationEvaluatePath(&fpe, startSec + 1, &otherPath, 0, T_MAX_SEC);
+
+		int t;
+		int tLinear;
+		EAlarmLevel level = coneCheckCalculate(&own, &otherPath, vOtherMsSqu, 2, 3, &t);
+		EAlarmLevel levelLinear = coneCheckCalculateLinear(&own, &ownVel, &fpe, startSec,
+			vOtherMsSqu, 2, 3, &tLinear);
+		isEqual &= level == levelLinear && (level == ALARM_LEVEL_NONE || t == tLinear);
+		nofLevels[level]++;
+	}
+	printf("    levels 0/1/2/3: %d/%d/%d/%d\n",
+		nofLevels[0], nofLevels[1], nofLevels[2], nofLevels[3]);
+	testCheck("solver equals all samples", isEqual);
+}
+#endif
+
 static void testPrediction(void)
 {
 	printf("testPredictions\n");
@@ -141,15 +795,16 @@ static void testPrediction(void)
 	uint32_t ts = 0;
 	EOcapPathModel pathModel = OCAP_PATH_MODEL_LINEAR;
 
-	// Create 2 flight objects (ours and another one).
+	// Create 4 flight objects (ours and 3 others).
 
-	flightObjectListInit(1);
+	flightObjectListInit(&sCtx, 1);
 
-	TFlightObjectOwn *ownFlightObject = flightObjectListGetOwn();
-	TFlightObjectOther *otherFlightObject = flightObjectListAddOther(2);
-	TFlightObjectOther *thirdFlightObject = flightObjectListAddOther(3);
+	TFlightObjectOwn *ownFlightObject = flightObjectListGetOwn(&sCtx);
+	TFlightObjectOther *otherFlightObject = flightObjectListAddOther(&sCtx, 2);
+	TFlightObjectOther *thirdFlightObject = flightObjectListAddOther(&sCtx, 3);
+	TFlightObjectOther *fourthFlightObject = flightObjectListAddOther(&sCtx, 4);
 
-	// Provide data for the 2 flight objects.
+	// Provide data for the flight objects.
 
 	// In the first step, provide data only for our own airplane.
 	ts = 0;
@@ -157,44 +812,440 @@ static void testPrediction(void)
 	TVector ownV0;
 	vectorInit(&ownR0, 0, 0, 0);
 	vectorInit(&ownV0, 0, 100, 0);
-	calculateOwnDataFromGpsInfo(ts, &ownR0, &ownV0);
+	calculateOwnDataFromGpsInfo(&sCtx, ts, &ownR0, &ownV0);
 
-	// In the second step, provide data for our own and for two other airplanes.
+	// In the second step, provide data for our own and for the other airplanes.
 	ts = 1;
 	TVector ownR1;
 	TVector ownV1;
 	vectorInit(&ownR1, .99997, 99.99333, 0);
 	// Flying from S to NNE, at (873,2823,0) after 30s
 	vectorInit(&ownV1, 1.99987, 99.98000, 0);
-	calculateOwnDataFromGpsInfo(ts, &ownR1, &ownV1);
+	calculateOwnDataFromGpsInfo(&sCtx, ts, &ownR1, &ownV1);
+	// The predicted own flight path is a circle with r=100m around (100,0,0),
+	// see FL-OWN-R-Zxy-V.
 
 	TVector otherR1;
 	TVector otherV1;
 	TVector otherZ;
-	// Flying from W to E, at (873,2823,0) after 30s
-	vectorInit(&otherR1, 0, 2823, 0);
+	// Flying from W to E through our circle, alarm level 3.
+	vectorInit(&otherR1, -900, 50, 0);
 	vectorInit(&otherV1, 30, 0, 0);
 	vectorInit(&otherZ, 0, -50000, 0);
-	calculateOtherDataFromInfo(otherFlightObject, ts, &otherR1, &otherV1, &otherZ, pathModel);
+	calculateOtherDataFromInfo(&sCtx, otherFlightObject, ts, &otherR1, &otherV1, &otherZ, pathModel);
 
 	TVector thirdR1;
 	TVector thirdV1;
 	TVector thirdZ;
-	// Flying from W to E, at (873,2823,0) after 30s
-	vectorInit(&thirdR1, 1400, 3400, 0);
-	vectorInit(&thirdV1, 3, 3, 0);
+	// Slowly flying N at the edge of the reach: still alarm level 1 (at
+	// about 1250m from (100,0,0), there is no more alarm; the reachability
+	// filter only skips from about 1350m on).
+	vectorInit(&thirdR1, 1340, 0, 0);
+	vectorInit(&thirdV1, 0, 1, 0);
 	vectorInit(&thirdZ, 0, +40000, 0);
-	calculateOtherDataFromInfo(thirdFlightObject, ts, &thirdR1, &thirdV1, &thirdZ, pathModel);
+	calculateOtherDataFromInfo(&sCtx, thirdFlightObject, ts, &thirdR1, &thirdV1, &thirdZ, pathModel);
+
+	TVector fourthR1;
+	TVector fourthV1;
+	TVector fourthZ;
+	// The same beyond the reach: skipped (FLOBJ-OUT-OF-REACH).
+	vectorInit(&fourthR1, 1500, 0, 0);
+	vectorInit(&fourthV1, 0, 1, 0);
+	vectorInit(&fourthZ, 0, +40000, 0);
+	calculateOtherDataFromInfo(&sCtx, fourthFlightObject, ts, &fourthR1, &fourthV1, &fourthZ, pathModel);
 
 	// Configure collision prediction.
 
-	predictionInit(30, 2, 4);
+	predictionInit(&sCtx, 30, 2, 4);
 
 	// Perform collision prediction.
 
-	predictionCalculateAlarmStates(ts);
+	predictionCalculateAlarmStates(&sCtx, ts);
 
 	// Show the result.
 
-	alarmStateListDump();
+	alarmStateListDump(&sCtx);
+}
+
+// Predicts right after ocapContextInitWithMemory, without
+// flightObjectListInit: the setup of README.md.
+static void testPredictionFreshContext(void)
+{
+	printf("testPredictionFreshContext\n");
+
+	static TOcapContext ctx;
+	TOcapCapacities capacities;
+	ocapCapacitiesInitDefault(&capacities);
+	uint8_t *memory = testInitContext(&ctx, &capacities);
+	TFlightObjectOther *f = flightObjectListAddOther(&ctx, 2);
+
+	// Flying N; the other one comes towards us on a curved path (ARC).
+	int level = ALARM_LEVEL_NONE;
+	for (uint32_t ts = 0; ts < 3; ts++) {
+		TVector r;
+		TVector v;
+		TVector z;
+		vectorInit(&r, 0, 50.0 * ts, 0);
+		vectorInit(&v, 0, 50, 0);
+		calculateOwnDataFromGpsInfo(&ctx, ts, &r, &v);
+		vectorInit(&r, 0, 1500 - 50.0 * ts, 0);
+		vectorInit(&v, 0, -50, 0);
+		vectorInit(&z, 20000, 0, 0);
+		calculateOtherDataFromInfo(&ctx, f, ts, &r, &v, &z, OCAP_PATH_MODEL_ARC);
+		predictionCalculateAlarmStates(&ctx, ts);
+		if (alarmStateListGetCount(&ctx) > 0) {
+			level = alarmStateListGetAtIndex(&ctx, 0)->level;
+		}
+	}
+	testCheck("ARC alarm without list init", level == ALARM_LEVEL_3);
+
+	// The cleared alarm finds the aircraft by its handle.
+	TAlarmEvent e;
+	while (alarmEventQueuePop(&ctx, &e)) {
+	}
+	alarmStateListClear(&ctx);
+	alarmEventQueueUpdate(&ctx, 3);
+	testCheck("distance of cleared alarm", alarmEventQueuePop(&ctx, &e)
+		&& e.type == ALARM_EVENT_CLEARED && e.distMtr > 1000);
+
+	ocapContextExit(&ctx);
+	delete[] memory;
+}
+
+// Position and velocity of aircraft i of testPredictionGround at ts: a
+// head-on pair flying E and W, a third one crossing their path to the N and
+// a fourth one far away.
+static void testPredictionGroundGetData(int i, uint32_t ts, TVector *r, TVector *v)
+{
+	static const float data[4][4] = {
+		{ -1500, 0, 50, 0 }, { 1500, 20, -50, 0 }, { 10, -1300, 0, 45 }, { 0, 9000, 40, 0 }
+	};
+	vectorInit(v, data[i][2], data[i][3], 0);
+	vectorInit(r, data[i][0] + data[i][2] * ts, data[i][1] + data[i][3] * ts, 0);
+}
+
+// The ground station mode calculates the alarms of every aircraft as a
+// context with this aircraft as our own one does.
+static void testPredictionGround(void)
+{
+	printf("testPredictionGround\n");
+
+	const int nofAircraft = 4;
+	static TOcapContext groundCtx;
+	static TOcapContext ownCtxs[nofAircraft];
+	TOcapCapacities capacities;
+	ocapCapacitiesInitDefault(&capacities);
+	capacities.flightObjects = 8;
+	uint8_t *ownMemory[nofAircraft];
+	for (int j = 0; j < nofAircraft; j++) {
+		ownMemory[j] = testInitContext(&ownCtxs[j], &capacities);
+		flightObjectListInit(&ownCtxs[j], 100 + j);
+	}
+	capacities.groundAlarmStates = capacities.alarmStates;
+	uint8_t *groundMemory = testInitContext(&groundCtx, &capacities);
+	for (int j = 0; j < nofAircraft; j++) {
+		flightObjectListAddOther(&groundCtx, 100 + j);
+	}
+
+	int isEqual = 1;
+	int nofAlarms = 0;
+	for (uint32_t ts = 0; ts < 10; ts++) {
+		TVector r;
+		TVector v;
+		TVector z;
+		vectorInit(&z, 0, 0, 0);
+		for (int i = 0; i < nofAircraft; i++) {
+			testPredictionGroundGetData(i, ts, &r, &v);
+			calculateOtherDataFromInfo(&groundCtx, flightObjectListGetOther(&groundCtx, 100 + i),
+				ts, &r, &v, &z, OCAP_PATH_MODEL_LINEAR);
+			for (int j = 0; j < nofAircraft; j++) {
+				if (i == j) {
+					calculateOwnDataFromGpsInfo(&ownCtxs[j], ts, &r, &v);
+					continue;
+				}
+				TFlightObjectOther *f = flightObjectListGetOther(&ownCtxs[j], 100 + i);
+				if (!f) {
+					f = flightObjectListAddOther(&ownCtxs[j], 100 + i);
+				}
+				calculateOtherDataFromInfo(&ownCtxs[j], f, ts, &r, &v, &z, OCAP_PATH_MODEL_LINEAR);
+			}
+		}
+
+		// Our own flight path needs the positions of the last
+		// FLIGHT_OBJECT_OWN_EXTRAPOLATION_DEPTH_SEC seconds.
+		predictionCalculateAlarmStatesGround(&groundCtx, ts);
+		for (int j = 0; j < nofAircraft; j++) {
+			predictionCalculateAlarmStates(&ownCtxs[j], ts);
+			if (ts < FLIGHT_OBJECT_OWN_EXTRAPOLATION_DEPTH_SEC - 1) {
+				continue;
+			}
+			TFlightObjectOther *f = flightObjectListGetOther(&groundCtx, 100 + j);
+			int n = alarmStateListGetCount(&ownCtxs[j]);
+			isEqual &= groundAlarmListGetCount(&groundCtx, f) == n;
+			for (int k = 0; isEqual && k < n; k++) {
+				TAlarmState *a = alarmStateListGetAtIndex(&ownCtxs[j], k);
+				TAlarmState *g = groundAlarmListGetAtIndex(&groundCtx, f, k);
+				isEqual &= g->flightObject->id == a->flightObject->id
+					&& g->level == a->level
+					&& g->timeToEncounterSec == a->timeToEncounterSec;
+			}
+			nofAlarms += n;
+		}
+	}
+	printf("    alarm states in 6 ticks: %d\n", nofAlarms);
+	testCheck("ground alarms found", nofAlarms > 0);
+	testCheck("ground equals own contexts", isEqual);
+
+	ocapContextExit(&groundCtx);
+	delete[] groundMemory;
+	for (int j = 0; j < nofAircraft; j++) {
+		ocapContextExit(&ownCtxs[j]);
+		delete[] ownMemory[j];
+	}
+}
+
+// Position and velocity of aircraft i of testPredictionGlobal at ts,
+// relative to the start of our own aircraft: we fly E, the others circle
+// (ARC) along our track. The centre z is relative to the position.
+static void testPredictionGlobalGetData(int i, uint32_t ts, TLocalFrameGlobalPos *r,
+	TVector *v, TVector *z)
+{
+	if (i < 0) {
+		r->x = 70.0 * ts;
+		r->y = 0;
+		r->z = 1000;
+		vectorInit(v, 70, 0, 0);
+		return;
+	}
+	const double radius = 200;
+	double w = (i % 2 ? 1 : -1) * 25 / radius;
+	double a = i * 1.3 + w * ts;
+	double cx = 700.0 * i + 300;
+	double cy = ((i % 5) - 2) * 150.0;
+	r->x = cx + radius * cos(a);
+	r->y = cy + radius * sin(a);
+	r->z = 1000 + ((i % 3) - 1) * 30.0;
+	vectorInit(v, -w * radius * sin(a), w * radius * cos(a), 0);
+	vectorInit(z, cx - r->x, cy - r->y, 0);
+}
+
+// The global API (about 5e6m from the global origin, with a re-base every
+// LOCAL_FRAME_REBASE_MTR) calculates the same alarms as the same scenario
+// at the origin with the local one.
+static void testPredictionGlobal(void)
+{
+	printf("testPredictionGlobal\n");
+
+	const int nofOthers = 60;
+	static TOcapContext localCtx;
+	static TOcapContext globalCtx;
+	TOcapCapacities capacities;
+	ocapCapacitiesInitDefault(&capacities);
+	uint8_t *localMemory = testInitContext(&localCtx, &capacities);
+	uint8_t *globalMemory = testInitContext(&globalCtx, &capacities);
+	TLocalFrameGlobalPos start = { 600000, 5200000, 0 };
+
+	int isEqual = 1;
+	int nofAlarms = 0;
+	int nofRebases = 0;
+	for (uint32_t ts = 0; ts < 600; ts++) {
+		for (int i = -1; i < nofOthers; i++) {
+			TLocalFrameGlobalPos r;
+			TVector v;
+			TVector z;
+			testPredictionGlobalGetData(i, ts, &r, &v, &z);
+			TVector localR;
+			vectorInit(&localR, (float)r.x, (float)r.y, (float)r.z);
+			r.x += start.x;
+			r.y += start.y;
+			r.z += start.z;
+			if (i < 0) {
+				double originX = globalCtx.localFrame.origin.x;
+				calculateOwnDataFromGpsInfo(&localCtx, ts, &localR, &v);
+				calculateOwnDataFromGlobalGpsInfo(&globalCtx, ts, &r, &v);
+				nofRebases += globalCtx.localFrame.origin.x != originX;
+			} else if ((ts + i) % 3) {
+				// Every third packet is lost: the stored position is shifted
+				// by a re-base.
+				rxQueuePush(&localCtx, 1000 + i, ts, &localR, &v, &z, OCAP_PATH_MODEL_ARC);
+				rxQueuePushGlobal(&globalCtx, 1000 + i, ts, &r, &v, &z, OCAP_PATH_MODEL_ARC);
+			}
+		}
+		predictionCalculateAlarmStates(&localCtx, ts);
+		predictionCalculateAlarmStates(&globalCtx, ts);
+
+		// See testPredictionGround.
+		if (ts < FLIGHT_OBJECT_OWN_EXTRAPOLATION_DEPTH_SEC - 1) {
+			continue;
+		}
+		int n = alarmStateListGetCount(&localCtx);
+		isEqual &= alarmStateListGetCount(&globalCtx) == n;
+		for (int k = 0; isEqual && k < n; k++) {
+			TAlarmState *l = alarmStateListGetAtIndex(&localCtx, k);
+			TAlarmState *g = alarmStateListGetAtIndex(&globalCtx, k);
+			isEqual &= g->flightObject->id == l->flightObject->id
+				&& g->level == l->level
+				&& g->timeToEncounterSec == l->timeToEncounterSec;
+		}
+		nofAlarms += n;
+	}
+	printf("    re-bases: %d, alarm states: %d\n", nofRebases, nofAlarms);
+	testCheck("re-based", nofRebases > 10);
+	testCheck("global alarms found", nofAlarms > 0);
+#if FLIGHT_OBJECT_OTHER_PATH_CACHE_QUANTIZED == 0
+	// The quantized paths are rounded in the local frame, and at the origin
+	// we leave their range.
+	testCheck("global equals origin", isEqual);
+#endif
+
+	ocapContextExit(&globalCtx);
+	delete[] globalMemory;
+	ocapContextExit(&localCtx);
+	delete[] localMemory;
+}
+
+#if PREDICTION_THREADS_MAX > 1
+// Provides the same data to the serial and the parallel context: we fly N,
+// many others fly towards our start position from all directions.
+static void testPredictionParallelProvide(TOcapContext *ctx, uint32_t ts, int nofOthers)
+{
+	TVector r;
+	TVector v;
+	TVector z;
+	vectorInit(&r, 0, 50.0 * ts, 0);
+	vectorInit(&v, 0, 50, 0);
+	calculateOwnDataFromGpsInfo(ctx, ts, &r, &v);
+
+	for (int i = 0; i < nofOthers; i++) {
+		TFlightObjectOther *f = flightObjectListGetOther(ctx, 1000 + i);
+		if (!f) {
+			f = flightObjectListAddOther(ctx, 1000 + i);
+		}
+		double a = i * 2.399963;
+		double d = 300 + 10 * (i % 97) - 20.0 * ts;
+		double speed = 10 + i % 30;
+		vectorInit(&r, d * cos(a), d * sin(a), (i % 7) * 20.0 - 60);
+		vectorInit(&v, -speed * cos(a), -speed * sin(a), 0);
+		vectorInit(&z, 0, (i % 2 ? 1 : -1) * 40000.0, 0);
+		calculateOtherDataFromInfo(ctx, f, ts, &r, &v, &z, OCAP_PATH_MODEL_LINEAR);
+	}
+}
+
+static void testPredictionParallel(void)
+{
+	printf("testPredictionParallel\n");
+
+	const int nofOthers = 200;
+	static TOcapContext serialCtx;
+	static TOcapContext parallelCtx;
+	TOcapCapacities capacities;
+	ocapCapacitiesInitDefault(&capacities);
+	capacities.flightObjects = 256;
+	capacities.alarmStates = 32;
+	uint8_t *serialMemory = testInitContext(&serialCtx, &capacities);
+	capacities.predictionThreads = 4;
+	uint8_t *parallelMemory = testInitContext(&parallelCtx, &capacities);
+	testCheck("threads started", parallelCtx.predictionThreads.nofThreads == 4);
+
+	TOcapContext *ctxs[2] = { &serialCtx, &parallelCtx };
+	for (int c = 0; c < 2; c++) {
+		flightObjectListInit(ctxs[c], 1);
+		predictionInit(ctxs[c], 30, 2, 4);
+	}
+
+	// The threads get a new job each tick; the alarm states must be the
+	// same as the serial ones, in the same order.
+	int isEqual = 1;
+	int nofAlarms = 0;
+	for (uint32_t ts = 0; ts < 10; ts++) {
+		for (int c = 0; c < 2; c++) {
+			testPredictionParallelProvide(ctxs[c], ts, nofOthers);
+		}
+		predictionCalculateAlarmStates(&serialCtx, ts);
+		predictionCalculateAlarmStatesParallel(&parallelCtx, ts);
+
+		int n = alarmStateListGetCount(&serialCtx);
+		isEqual &= alarmStateListGetCount(&parallelCtx) == n;
+		for (int i = 0; isEqual && i < n; i++) {
+			TAlarmState *s = alarmStateListGetAtIndex(&serialCtx, i);
+			TAlarmState *p = alarmStateListGetAtIndex(&parallelCtx, i);
+			isEqual &= s->flightObjectHandle == p->flightObjectHandle
+				&& s->level == p->level
+				&& s->timeToEncounterSec == p->timeToEncounterSec
+				&& !memcmp(&s->curDistanceToFlightObject,
+					&p->curDistanceToFlightObject, sizeof(TVector));
+		}
+		nofAlarms += n;
+	}
+	printf("    alarm states in 10 ticks: %d\n", nofAlarms);
+	testCheck("alarms found", nofAlarms > 0);
+	testCheck("parallel equals serial", isEqual);
+
+	ocapContextExit(&parallelCtx);
+	testCheck("threads stopped", parallelCtx.predictionThreads.nofThreads == 0);
+	ocapContextExit(&serialCtx);
+	delete[] parallelMemory;
+	delete[] serialMemory;
+}
+#endif
+
+static void testFlightPathExtrapolationAccuracy(void)
+{
+	// A turn (radius 200m at 50m/s) and a straight flight at ECEF
+	// magnitudes (about 4600km from the origin, float resolution 0.5m).
+	// The reference is the motion of the model (circle or line) in double
+	// precision, from the same input.
+	printf("testFlightPathExtrapolationAccuracy\n");
+
+	for (int isArc = 0; isArc < 2; isArc++) {
+		TFlightPathExtrapolationData fpe = {};
+		vectorInit(&fpe.ri_vec, 4321567, 654321, 4612345);
+		if (isArc) {
+			vectorInit(&fpe.vi_vec, -40, 30, 0);
+		} else {
+			vectorInit(&fpe.vi_vec, 37.3, 41.7, -1.3);
+		}
+		vectorInit(&fpe.z_vec, 4321567 - 120, 654321 - 160, 4612345);
+		vectorCopy(&fpe.r0_vec, &fpe.ri_vec);
+		vectorCopy(&fpe.v0_vec, &fpe.vi_vec);
+		fpe.predictionModel = isArc ? OCAP_PATH_MODEL_ARC : OCAP_PATH_MODEL_LINEAR;
+		flightPathExtrapolationPrepareRvz(&fpe);
+
+		// d := r - Z, the motion on the circle is Z + cos(wt) * d + sin(wt)/w * v.
+		double r[3] = { fpe.ri_vec.x, fpe.ri_vec.y, fpe.ri_vec.z };
+		double v[3] = { fpe.vi_vec.x, fpe.vi_vec.y, fpe.vi_vec.z };
+		double z[3] = { fpe.z_vec.x, fpe.z_vec.y, fpe.z_vec.z };
+		double d[3] = { r[0] - z[0], r[1] - z[1], r[2] - z[2] };
+		double w = sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2])
+			/ sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+
+		TFlightPathExtrapolationData steps = fpe;
+		double maxErrorSteps = 0;
+		double maxErrorClosedForm = 0;
+		for (int t = 1; t <= T_MAX_SEC; t++) {
+			double ref[3];
+			for (int i = 0; i < 3; i++) {
+				ref[i] = isArc
+					? z[i] + cos(w * t) * d[i] + sin(w * t) / w * v[i]
+					: r[i] + t * v[i];
+			}
+
+			flightPathExtrapolationExecute(&steps);
+			TVector pos, vel;
+			flightPathExtrapolationEvaluate(&fpe, t, &pos, &vel);
+
+			double errorSteps = sqrt(pow(steps.ri_vec.x - ref[0], 2)
+				+ pow(steps.ri_vec.y - ref[1], 2) + pow(steps.ri_vec.z - ref[2], 2));
+			double errorClosedForm = sqrt(pow(pos.x - ref[0], 2)
+				+ pow(pos.y - ref[1], 2) + pow(pos.z - ref[2], 2));
+			maxErrorSteps = std::max(maxErrorSteps, errorSteps);
+			maxErrorClosedForm = std::max(maxErrorClosedForm, errorClosedForm);
+		}
+
+		// The closed form must stay within the float resolution.
+		printf("    %-6s steps %6.2fm, closed form %4.2fm\n",
+			isArc ? "ARC" : "LINEAR", maxErrorSteps, maxErrorClosedForm);
+		testCheck("closed form within float resolution",
+			maxErrorClosedForm <= 0.5 && maxErrorClosedForm <= maxErrorSteps);
+	}
 }
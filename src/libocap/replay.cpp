@@ -0,0 +1,247 @@
+//
+// replay.cpp
+//
+// OCAP - Open Collision Avoidance Protocol
+//
+// Replays a recording of InputRecorder.h at full speed and prints the
+// time per prediction, e.g. to reproduce a field session or as a
+// benchmark. Build with "make replay" (with the DEFS of the recording
+// device to get the same alarm states).
+//
+// 17.10.2026 ASR  First version.
+//
+// Software License (BSD):
+// Copyright 2026 Classy Code GmbH.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contribu-
+//    tors may be used to endorse or promote products derived from this soft-
+//    ware without specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS “AS IS”
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "OcapContext.h"
+#include "InputRecorder.h"
+#include "AlarmStateList.h"
+#include "AlarmEventQueue.h"
+#include "GroundAlarmList.h"
+#include "FlightObjectList.h"
+#include "OcapLog.h"
+
+typedef struct {
+	int nofRecords;
+	int nofPredictions;
+	int nofAlarmStates;
+	double predictionNsSum;
+	double predictionNsMax;
+	double totalNs;
+} TReplayStatistics;
+
+static void replayPrintUsageAndExit(const char *appName);
+static int replayReadFile(const char *path, std::vector<uint8_t> *data);
+static int replaySession(std::vector<uint8_t> *data, int isVerbose, TReplayStatistics *stat);
+static int replayCountAlarmStates(TOcapContext *ctx, int isGround, uint32_t ts, int isVerbose);
+
+
+int main(int argc, char *argv[])
+{
+	int isVerbose = 0;
+	int nofRepeats = 1;
+	int argIx = 1;
+	while (argIx < argc - 1 && argv[argIx][0] == '-') {
+		if (!strcmp(argv[argIx], "-v")) {
+			isVerbose = 1;
+			argIx++;
+		} else if (!strcmp(argv[argIx], "-n") && argIx + 2 < argc) {
+			nofRepeats = atoi(argv[argIx + 1]);
+			argIx += 2;
+		} else {
+			replayPrintUsageAndExit(argv[0]);
+		}
+	}
+	if (argIx != argc - 1 || nofRepeats < 1) {
+		replayPrintUsageAndExit(argv[0]);
+	}
+
+	std::vector<uint8_t> data;
+	if (replayReadFile(argv[argIx], &data)) {
+		fprintf(stderr, "Failed to read %s\n", argv[argIx]);
+		return -1;
+	}
+
+	// Keep the fastest run.
+	TReplayStatistics best = {};
+	for (int r = 0; r < nofRepeats; r++) {
+		TReplayStatistics stat;
+		if (replaySession(&data, isVerbose && r == 0, &stat)) {
+			fprintf(stderr, "%s isn't a valid recording\n", argv[argIx]);
+			return -1;
+		}
+		if (r == 0 || stat.totalNs < best.totalNs) {
+			best = stat;
+		}
+	}
+
+	printf("records                     = %d\n", best.nofRecords);
+	printf("predictions                 = %d\n", best.nofPredictions);
+	printf("alarm states                = %d\n", best.nofAlarmStates);
+	printf("total time [ms]             = %.3f\n", best.totalNs / 1e6);
+	if (best.nofPredictions) {
+		printf("prediction mean / max [us]  = %.1f / %.1f\n",
+			best.predictionNsSum / best.nofPredictions / 1e3, best.predictionNsMax / 1e3);
+		printf("predictions per second      = %.0f\n",
+			best.nofPredictions / (best.predictionNsSum / 1e9));
+	}
+	return 0;
+}
+
+// The log of the library is switched off, so that only the library is
+// timed (these functions replace the ones of OcapLogSim.c).
+void ocapLogStrInt(const char *str, int i) {}
+void ocapLogStrIntInt(const char *str, int i, int j) {}
+void ocapLogFlVec(int own, TVector *pos, TVector *vel) {}
+void ocapLogFlTN(int nr, TVector *vecT, TVector *vecN) {}
+void ocapLogFlOwn(TFlightObjectOwn *flOwn) {}
+void ocapLogFlOwnPath(TFlightPath *ownFlightPath) {}
+void ocapLogFlOtherPath1(TVector *otherPos, int t) {}
+void ocapLogFlOtherTs(int rxTs, int ts) {}
+void ocapLogFpe(int own, TFlightPathExtrapolationData *fpe) {}
+void ocapLogRZxyV(int own, TFlightPathExtrapolationData *fpe) {}
+void ocapLogModelZxyzV10(int own, EOcapPathModel pathModel, int zx, int zy, int zz, int v10) {}
+
+static void replayPrintUsageAndExit(const char *appName)
+{
+	fprintf(stderr, "usage: %s [-v] [-n <repeats>] <recording>\n", appName);
+	fprintf(stderr, "Replays a recording of InputRecorder.h on a new context as fast as\n");
+	fprintf(stderr, "possible and prints the time per prediction (of the fastest of\n");
+	fprintf(stderr, "<repeats> runs). With -v, prints the alarm states and alarm events\n");
+	fprintf(stderr, "after each prediction.\n");
+	exit(-1);
+}
+
+static int replayReadFile(const char *path, std::vector<uint8_t> *data)
+{
+	FILE *f = fopen(path, "rb");
+	if (!f) {
+		return -1;
+	}
+	uint8_t buf[4096];
+	size_t n;
+	while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+		data->insert(data->end(), buf, buf + n);
+	}
+	fclose(f);
+	return 0;
+}
+
+// Replays the whole recording on a new context. The recording is in
+// memory, so only the library is timed.
+static int replaySession(std::vector<uint8_t> *data, int isVerbose, TReplayStatistics *stat)
+{
+	memset(stat, 0, sizeof(TReplayStatistics));
+	const uint8_t *p = data->data();
+	int size = (int)data->size();
+
+	TOcapCapacities capacities;
+	int headerSize = inputRecorderReadHeader(p, size, &capacities);
+	size_t memorySize = headerSize < 0 ? 0 : ocapContextGetMemorySize(&capacities);
+	if (memorySize == 0) {
+		return -1;
+	}
+	std::vector<uint8_t> memory(memorySize);
+	TOcapContext *ctx = new TOcapContext;
+	ocapContextInitWithMemory(ctx, &capacities, memory.data(), memorySize);
+	p += headerSize;
+	size -= headerSize;
+
+	auto start = std::chrono::steady_clock::now();
+	while (size > 0) {
+		EInputRecordType type = (EInputRecordType)p[0];
+		int isPrediction = type == INPUT_RECORD_PREDICTION
+			|| type == INPUT_RECORD_PREDICTION_GROUND;
+		auto predictionStart = std::chrono::steady_clock::now();
+		int n = inputRecorderReplay(ctx, p, size);
+		if (n < 0) {
+			// Truncated at the end (e.g. power loss during the recording).
+			break;
+		}
+		if (isPrediction) {
+			auto predictionEnd = std::chrono::steady_clock::now();
+			double ns = std::chrono::duration<double, std::nano>(
+				predictionEnd - predictionStart).count();
+			stat->predictionNsSum += ns;
+			if (ns > stat->predictionNsMax) {
+				stat->predictionNsMax = ns;
+			}
+			stat->nofPredictions++;
+
+			uint32_t ts = p[2] | (p[3] << 8) | (p[4] << 16) | ((uint32_t)p[5] << 24);
+			stat->nofAlarmStates += replayCountAlarmStates(ctx,
+				type == INPUT_RECORD_PREDICTION_GROUND, ts, isVerbose);
+		}
+		stat->nofRecords++;
+		p += n;
+		size -= n;
+	}
+	auto end = std::chrono::steady_clock::now();
+	stat->totalNs = std::chrono::duration<double, std::nano>(end - start).count();
+	delete ctx;
+	return 0;
+}
+
+// Returns the number of alarm states after a prediction and consumes the
+// alarm events.
+static int replayCountAlarmStates(TOcapContext *ctx, int isGround, uint32_t ts, int isVerbose)
+{
+	int count = 0;
+	if (isGround) {
+		for (int i = 0; i < flightObjectListGetOtherCount(ctx); i++) {
+			TFlightObjectOther *f = flightObjectListGetOtherAtIndex(ctx, i);
+			for (int j = 0; j < groundAlarmListGetCount(ctx, f); j++) {
+				TAlarmState *as = groundAlarmListGetAtIndex(ctx, f, j);
+				if (isVerbose) {
+					printf("%u: %u -> %u level %d in %ds\n", ts, f->id,
+						as->flightObject->id, as->level, as->timeToEncounterSec);
+				}
+				count++;
+			}
+		}
+	} else {
+		for (int i = 0; i < alarmStateListGetCount(ctx); i++) {
+			TAlarmState *as = alarmStateListGetAtIndex(ctx, i);
+			if (isVerbose) {
+				printf("%u: %u level %d in %ds\n", ts, as->flightObject->id,
+					as->level, as->timeToEncounterSec);
+			}
+			count++;
+		}
+	}
+
+	TAlarmEvent e;
+	while (alarmEventQueuePop(ctx, &e)) {
+		if (isVerbose) {
+			printf("%u: event %d %u level %d -> %d\n", ts, e.type, e.id,
+				e.previousLevel, e.level);
+		}
+	}
+	return count;
+}
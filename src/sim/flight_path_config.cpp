@@ -42,22 +42,18 @@
 #include "workspace.h"
 
 #include "AlarmService.h"
+#include "AlarmEventQueue.h"
 #include "AlarmStateList.h"
-#include "CalculateOtherData.h"
 #include "CalculateOwnData.h"
 #include "Configuration.h"
 #include "FlightObjectList.h"
 #include "FlightObjectOrientation.h"
 #include "FlightPathExtrapolation.h"
 #include "Prediction.h"
+#include "RxQueue.h"
 
 static int sNextIdNr = 1;
 
-// From Prediction.c
-extern TVector sOwnFlightPath[T_MAX_SEC];
-extern TVector *sOtherFlightPath; // [20][T_MAX_SEC];
-extern uint32_t *sOtherFlightPathIdNr; // [20];
-
 static float convert_latDegN_E5_toMtr(int32_t latDegN_E5);
 static float convert_lonDegE_E5_toMtr(int32_t lonDegE_E5, int32_t latDegN_E5);
 
@@ -220,7 +216,7 @@ void FlightPathConfig::StartCollisionWarning()
 {
     // Create our flight object and register for radio packets.
 
-    flightObjectListInit(idNr);
+    flightObjectListInit(Workspace::Instance()->GetOcapContext(), idNr);
 }
 
 // Call this method at the end of each second.
@@ -243,26 +239,88 @@ void FlightPathConfig::YieldSimulationPrediction(long ms)
         return;
     }
 
-    calculateOwnDataFromGpsInfo(ts, posNewMtr.GetVector(), velNewMtrSec.GetVector());
+    TOcapContext *ctx = Workspace::Instance()->GetOcapContext();
+    calculateOwnDataFromGpsInfo(ctx, ts, posNewMtr.GetVector(), velNewMtrSec.GetVector());
 
     // Perform collision prediction; this creates "alarm state" instances.
-    predictionCalculateAlarmStates(ts);
+    // With a parameter sweep, also for each parameter set.
+    TOcapContext *sweepCtx = Workspace::Instance()->GetSweepContexts();
+    int nofSweepSets = Workspace::Instance()->GetNofSweepSets();
+#if PREDICTION_THREADS_MAX > 1
+    // Parallel variant of libocap (make batch-parallel); the parameter sweep
+    // runs on one thread.
+    if (nofSweepSets == 0) {
+        predictionCalculateAlarmStatesParallel(ctx, ts);
+    } else {
+        predictionCalculateAlarmStatesSweep(ctx, ts, sweepCtx, nofSweepSets);
+    }
+#else
+    predictionCalculateAlarmStatesSweep(ctx, ts, sweepCtx, nofSweepSets);
+#endif
 
     // Display the result (alarm information).
     UpdateAlarmInformation();
+
+    for (int j = 0; j < nofSweepSets; j++) {
+        CalculateAlarmInformation(&sweepCtx[j], Workspace::Instance()->GetSweepAlarmInformation(j));
+    }
 }
 
 void FlightPathConfig::UpdateAlarmInformation()
 {
+    TOcapContext *ctx = Workspace::Instance()->GetOcapContext();
+
     // Dump all alarm states (one for each aircraft generating an alarm) to the console.
-    alarmStateListDump();
+    alarmStateListDump(ctx);
+
+    SAlarmInformation info;
+    CalculateAlarmInformation(ctx, &info);
+    if (info.fpcOther) {
+        info.fpcOther->alarmMessage = info.alarmMessage;
+        info.fpcOther->alarmLevel = info.alarmLevel; // downscaled 0-3
+        info.fpcOther->alarmIntensity = info.alarmIntensity; // 0-12, filtered by AlarmService
+    }
+
+    // Filtered alarm levels of all aircraft, for the object window.
+    alarmServiceUpdate(ctx);
+    for (int i = 0, imax = alarmServiceGetCount(ctx); i < imax; i++) {
+        TAlarmServiceEntry *e = alarmServiceGetAtIndex(ctx, i);
+        FlightPathConfig *fpcOther = Workspace::Instance()->GetFlightPathByIdNr(e->flightObject->id);
+        if (fpcOther) {
+            fpcOther->alarmServiceLevel = alarmServiceGetLevel(e);
+        }
+    }
+
+    // Changes of the alarms, as an audio or display task would consume them.
+    TAlarmEvent ev;
+    while (alarmEventQueuePop(ctx, &ev)) {
+        printf("Alarm event %d: %x L%d -> L%d dt=%ds d=%dm\n", (int)ev.type, ev.id,
+            (int)ev.previousLevel, (int)ev.level, ev.timeToEncounterSec, ev.distMtr);
+    }
+
+    // It's also possible to use directly the alarm state, with the following code.
+    // But by using the AlarmService, we get smoother warnings.
+    // if (theA) {
+    //     FlightPathConfig *fpcOther = Workspace::Instance()->GetFlightPathByIdNr(theA->flightObject->id);
+    //     fpcOther->alarmMessage = buf;
+    //     fpcOther->alarmLevel = theA->level;
+    //     fpcOther->alarmIntensity = (int)theA->level;
+    // }
+}
+
+// Updates the alarm service of alarmCtx (the context of libocap or a
+// parameter set of the sweep) with its alarm states and returns the alarm
+// to display in info.
+void FlightPathConfig::CalculateAlarmInformation(TOcapContext *alarmCtx, SAlarmInformation *info)
+{
+    TOcapContext *ctx = Workspace::Instance()->GetOcapContext();
 
 	// Get the most critical alarm state, skipping very close (0s, 1s) ones.
-    int nofAlarms = alarmStateListGetCount();
+    int nofAlarms = alarmStateListGetCount(alarmCtx);
     TAlarmState *theA = NULL;
     if (nofAlarms > 0) {
 		for (int i = 0; i < nofAlarms; i++) {
-			TAlarmState *curA = alarmStateListGetAtIndex(i);
+			TAlarmState *curA = alarmStateListGetAtIndex(alarmCtx, i);
 			// 29.04.2025 ASR  Reduced from 2 to 1 after tests from 27.04.
 			if (curA->timeToEncounterSec >= 1) {
 				theA = curA;
@@ -273,7 +331,7 @@ void FlightPathConfig::UpdateAlarmInformation()
 
 	// Calculate the distance and orientation from our own to the "offending" aircraft.
     // The vector from our own to the other aircraft is stored in vectorToOther.
-    TFlightObjectOwn *fOwn = flightObjectListGetOwn();
+    TFlightObjectOwn *fOwn = flightObjectListGetOwn(ctx);
 	TFlightObjectOrientation fo;
     TVector vectorToOtherMemory, *vectorToOther = &vectorToOtherMemory;
 	int hasOrientation = 0;
@@ -283,9 +341,11 @@ void FlightPathConfig::UpdateAlarmInformation()
 		vectorToOther = &theA->curDistanceToFlightObject;
     } else {
 		// No alarm state, so calculate the dist vector adhoc using the aircraft data.
-		TAlarmServiceEntry *eOld = alarmServiceGetMostCritical();
-		if (eOld && eOld->flightObject) {
-			TFlightObjectOther *fOther = eOld->flightObject;
+		// The aircraft may have been released in the meantime.
+		TAlarmServiceEntry *eOld = alarmServiceGetMostCritical(alarmCtx);
+		TFlightObjectOther *fOther = !eOld ? NULL
+			: flightObjectListGetOtherByHandle(ctx, eOld->flightObjectHandle);
+		if (fOther) {
 			vectorCopy(vectorToOther, &fOther->rxPos);
 			vectorSubtractVector(vectorToOther, &fOwn->rxPos);
         } else {
@@ -299,14 +359,17 @@ void FlightPathConfig::UpdateAlarmInformation()
 	}
 
     // Update the current alarm service; theA may be NULL, in this case the level decays.
-	alarmServiceUpdateMostCritical(theA, distMtr);
+	alarmServiceUpdateMostCritical(alarmCtx, theA, distMtr);
 
     // Reflect the alarm level on the flight path.
     // An alarm service entry may exist even if there was no alarm state in this round.
-    TAlarmServiceEntry *e = alarmServiceGetMostCritical();
-	if (e && e->level > 0 && e->flightObject) {
+    *info = SAlarmInformation();
+    TAlarmServiceEntry *e = alarmServiceGetMostCritical(alarmCtx);
+    TFlightObjectOther *fAlarm = !e ? NULL
+        : flightObjectListGetOtherByHandle(ctx, e->flightObjectHandle);
+	if (e && e->level > 0 && fAlarm) {
         FlightPathConfig *fpcOther =
-            Workspace::Instance()->GetFlightPathByIdNr(e->flightObject->id);
+            Workspace::Instance()->GetFlightPathByIdNr(fAlarm->id);
         if (fpcOther) {
             char buf[256] = { 0 };
             EAlarmLevel level = alarmServiceGetLevel(e);
@@ -319,20 +382,12 @@ void FlightPathConfig::UpdateAlarmInformation()
                         (int)level, theA->timeToEncounterSec);
                 }
             }
-            fpcOther->alarmMessage = &buf[0];
-            fpcOther->alarmLevel = level; // downscaled 0-3
-            fpcOther->alarmIntensity = e->level; // 0-12, filtered by AlarmService
+            info->fpcOther = fpcOther;
+            info->alarmMessage = &buf[0];
+            info->alarmLevel = level;
+            info->alarmIntensity = e->level;
         }
     }
-
-    // It's also possible to use directly the alarm state, with the following code.
-    // But by using the AlarmService, we get smoother warnings.
-    // if (theA) {
-    //     FlightPathConfig *fpcOther = Workspace::Instance()->GetFlightPathByIdNr(theA->flightObject->id);
-    //     fpcOther->alarmMessage = buf;
-    //     fpcOther->alarmLevel = theA->level;
-    //     fpcOther->alarmIntensity = (int)theA->level;
-    // }
 }
 
 // Call this method shortly after a new second has started.
@@ -359,7 +414,7 @@ void FlightPathConfig::YieldSimulationBroadcast(long ms)
         (float)posNewMtr.X(), (float)posNewMtr.Y(), (float)posNewMtr.Z(),
         (float)velNewMtrSec.X(), (float)velNewMtrSec.Y(), (float)velNewMtrSec.Z());
 
-    TFlightObjectOwn *f = flightObjectListGetOwn();
+    TFlightObjectOwn *f = flightObjectListGetOwn(Workspace::Instance()->GetOcapContext());
     float hasZVec = false;
     if (f->z_i_ctr > 0) {
         TVector rzVec;
@@ -451,22 +506,7 @@ void FlightPathConfig::OnReceiveMessage(RadioMessage &msg, double dbm)
 
     printf("----- OnReceiveMessage %s <- %d\n", GetIdentifier().c_str(), msg.sender->GetIdNr());
     int otherIdNr = msg.sender->GetIdNr();
-    TFlightObjectOther *fOther = nullptr;
-
-    // If we already know this object, we take it from the list of known objects.
-    for (int i = 0; i < flightObjectListGetOtherCount(); i++) {
-        TFlightObjectOther *fCur = flightObjectListGetOtherAtIndex(i);
-        if (fCur->id == otherIdNr) {
-            fOther = fCur;
-            break;
-        }
-    }
-
-    // If we don't know the object yet, we add it to the list.
-    if (!fOther) {
-        printf("adding %d\n", otherIdNr);
-        fOther = flightObjectListAddOther(otherIdNr);
-    }
+    TOcapContext *ctx = Workspace::Instance()->GetOcapContext();
 
     Vector3d posMtr, velMtrSec;
     Vector3d zMtr;
@@ -503,14 +543,16 @@ void FlightPathConfig::OnReceiveMessage(RadioMessage &msg, double dbm)
 
     TestSet *ts = TestSet::LoadedTestSet();
     if (ts) {
-        FlightPathConfig *fpcOther = ts->GetFlightPathByIdNr(fOther->id);
+        FlightPathConfig *fpcOther = ts->GetFlightPathByIdNr(otherIdNr);
         int packetRssi = 0; // TODO
         fpcOther->SetRssiAtSecond(msg.txStartTimeMs / 1000, packetRssi);
     }
 
-    // We update the data for this object.
-    calculateOtherDataFromInfo(
-        fOther,
+    // We queue the data for this object; the prediction applies it (and
+    // adds the object to the list of known objects, if necessary).
+    rxQueuePush(
+        ctx,
+        otherIdNr,
         msg.txStartTimeMs / 1000,
         posMtr.GetVector(),
         velMtrSec.GetVector(),
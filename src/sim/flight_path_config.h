@@ -43,6 +43,7 @@
 #include "FlightPathExtrapolation.h"
 
 #include "AlarmState.h"
+#include "OcapContext.h"
 
 using namespace linalg;
 
@@ -54,6 +55,16 @@ typedef struct {
 	uint8_t data[MAX_PACKET_LEN];
 } SPacket;
 
+class FlightPathConfig;
+
+// Alarm to display for the selected aircraft (from the alarm service).
+struct SAlarmInformation {
+	FlightPathConfig *fpcOther = nullptr; // nullptr if there is no alarm
+	std::string alarmMessage;
+	EAlarmLevel alarmLevel = ALARM_LEVEL_NONE;
+	int alarmIntensity = 0;
+};
+
 // A quadratic area.
 class FlightPathConfig : IRadioLinkSubscriber
 {
@@ -121,6 +132,9 @@ public:
 	std::string alarmMessage;
 	EAlarmLevel alarmLevel; // 0 = none, 1 = low, 3 = high
 	int alarmIntensity;
+	// Filtered alarm level of this aircraft (from the alarm service table),
+	// also while another aircraft is the most critical one.
+	EAlarmLevel alarmServiceLevel = ALARM_LEVEL_NONE;
 
 	// Displaying insights into the OCAP algorithm.
 	bool hasZVec = false;
@@ -132,6 +146,7 @@ public:
 private:
 	bool CalculatePosAndVel(long ms, linalg::Vector3d *posMtr, linalg::Vector3d *velMtrSec);
 	void UpdateAlarmInformation();
+	void CalculateAlarmInformation(TOcapContext *alarmCtx, SAlarmInformation *info);
 
 private:
 	FlightPath *flightPath = nullptr;
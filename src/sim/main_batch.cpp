@@ -0,0 +1,100 @@
+//
+// main_batch.cpp
+//
+// OCAP - Open Collision Avoidance Protocol
+//
+// OCAP simulation environment, batch mode without GUI (no OpenGL/GLUT).
+//
+// 17.10.2026 ASR  First version
+//
+// Software License (BSD):
+// Copyright 2026 Classy Code GmbH.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contribu-
+//    tors may be used to endorse or promote products derived from this soft-
+//    ware without specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS “AS IS”
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#include "workspace.h"
+
+static void printUsageAndExit(const char *appName);
+
+int main(int argc, char *argv[])
+{
+    // Optional parameter sweep, input recording and prediction threads.
+    const char *sweepPath = nullptr;
+    const char *recordingPath = nullptr;
+    int argIx = 1;
+    while (argc >= argIx + 2 && argv[argIx][0] == '-') {
+        if (!strcmp(argv[argIx], "-p")) {
+            sweepPath = argv[argIx + 1];
+        } else if (!strcmp(argv[argIx], "-r")) {
+            recordingPath = argv[argIx + 1];
+        } else if (!strcmp(argv[argIx], "-j")) {
+            Workspace::SetPredictionThreads(atoi(argv[argIx + 1]));
+        } else {
+            printUsageAndExit(argv[0]);
+        }
+        argIx += 2;
+    }
+    if (argc < argIx + 1) {
+        printUsageAndExit(argv[0]);
+    }
+
+    std::string outputFileName = "prediction_result.txt";
+    if (argc >= argIx + 2) {
+        outputFileName = argv[argIx + 1];
+    }
+
+    // Create the workspace; batch mode is always an autorun.
+    Workspace::Instance()->Initialize(argv[argIx], true, false, outputFileName);
+    if (sweepPath && !Workspace::Instance()->LoadPredictionSweep(sweepPath)) {
+        fprintf(stderr, "Failed to load %s\n", sweepPath);
+        return -1;
+    }
+    if (recordingPath) {
+        Workspace::Instance()->SetInputRecording(recordingPath);
+    }
+
+    Workspace::Instance()->RunAutoRun();
+    return 0;
+}
+
+void printUsageAndExit(const char *appName)
+{
+    fprintf(stderr, "usage: %s [-p <parameters>] [-r <recording>] [-j <threads>] <.tst> [<.txt>]\n",
+        appName);
+    fprintf(stderr, "Runs an OCAP test case without GUI and exits afterwards.\n");
+    fprintf(stderr, "Optionally specify a target file name for the result file.\n");
+    fprintf(stderr, "With -p, the prediction is also evaluated with each parameter set\n");
+    fprintf(stderr, "(\"k facLevel2 facLevel1\" per line) of the file, with the result\n");
+    fprintf(stderr, "files <.txt without extension>_p<n>.txt (n = 1 ... number of sets).\n");
+    fprintf(stderr, "With -r, the input of libocap is recorded into the file, to be\n");
+    fprintf(stderr, "replayed with ocap-replay (see ../libocap).\n");
+    fprintf(stderr, "With -j, the parallel variant (make batch-parallel) predicts on the given\n");
+    fprintf(stderr, "number of threads instead of one per core.\n");
+    exit(-1);
+}
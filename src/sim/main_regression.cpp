@@ -0,0 +1,311 @@
+//
+// main_regression.cpp
+//
+// OCAP - Open Collision Avoidance Protocol
+//
+// Runs all regression test cases in parallel and compares the results
+// with the reference output files.
+//
+// 17.10.2026 ASR  First version
+//
+// Software License (BSD):
+// Copyright 2026 Classy Code GmbH.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contribu-
+//    tors may be used to endorse or promote products derived from this soft-
+//    ware without specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS “AS IS”
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern char **environ;
+
+typedef struct {
+    std::string testSetPath;   // testflights/.../test_xyz.tst
+    std::string referencePath; // output/result_xyz.txt
+    std::string resultPath;    // <result dir>/result_xyz.txt
+} STestCase;
+
+typedef struct {
+    int sec;
+    int level;
+} SAlarm;
+
+static bool loadTestCases(const char *makefilePath, const std::string &resultDir,
+    std::vector<STestCase> &testCases);
+static bool runTestCase(const std::string &simBatchPath, const char *sweepPath,
+    int nofPredictionThreads, STestCase &tc);
+static bool filesAreEqual(const std::string &path1, const std::string &path2);
+static bool timelinesAreEqual(const std::string &path1, const std::string &path2,
+    int toleranceSec);
+static bool loadTimeline(const std::string &path, std::string &header,
+    std::vector<SAlarm> &alarms);
+static bool containsAlarms(const std::vector<SAlarm> &alarms,
+    const std::vector<SAlarm> &otherAlarms, int toleranceSec);
+static void printUsageAndExit(const char *appName);
+
+int main(int argc, char *argv[])
+{
+    // Default: run from the repository root, like the outermost Makefile.
+    const char *makefilePath = "Makefile";
+    std::string resultDir = "output_regression";
+    std::string simBatchPath = "./src/sim/sim-batch";
+    int nofCores = std::thread::hardware_concurrency();
+    int nofThreads = nofCores;
+    int toleranceSec = -1;
+    const char *sweepPath = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-j") && i + 1 < argc) {
+            nofThreads = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+            resultDir = argv[++i];
+        } else if (!strcmp(argv[i], "-s") && i + 1 < argc) {
+            simBatchPath = argv[++i];
+        } else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+            toleranceSec = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-p") && i + 1 < argc) {
+            sweepPath = argv[++i];
+        } else if (argv[i][0] == '-') {
+            printUsageAndExit(argv[0]);
+        } else {
+            makefilePath = argv[i];
+        }
+    }
+    if (nofThreads < 1) {
+        nofThreads = 1;
+    }
+    // The cores are shared by the test cases; this is the number of threads
+    // of the parallel prediction in each sim-batch (ignored by the serial one).
+    // At least 2, so that the worker threads also run with as many test cases
+    // as cores.
+    int nofPredictionThreads = std::max(2, nofCores / nofThreads);
+
+    std::vector<STestCase> testCases;
+    if (!loadTestCases(makefilePath, resultDir, testCases)) {
+        return -1;
+    }
+    mkdir(resultDir.c_str(), 0755);
+
+    printf("Running %d test cases on %d threads.\n", (int)testCases.size(), nofThreads);
+
+    // Each worker takes the next test case until all are done.
+    // Every test case runs in its own sim-batch process, so that the
+    // global state of libocap and the simulation singletons are isolated.
+    std::atomic<int> nextIx(0);
+    std::atomic<int> nofFailed(0);
+    std::mutex printMutex;
+
+    std::vector<std::thread> workers;
+    for (int w = 0; w < nofThreads; w++) {
+        workers.emplace_back([&]() {
+            for (;;) {
+                int ix = nextIx++;
+                if (ix >= (int)testCases.size()) {
+                    return;
+                }
+                STestCase &tc = testCases[ix];
+                bool hasRun = runTestCase(simBatchPath, sweepPath, nofPredictionThreads, tc);
+                bool isEqual = hasRun && (toleranceSec < 0
+                    ? filesAreEqual(tc.resultPath, tc.referencePath)
+                    : timelinesAreEqual(tc.resultPath, tc.referencePath, toleranceSec));
+                if (!isEqual) {
+                    nofFailed++;
+                }
+
+                std::lock_guard<std::mutex> lock(printMutex);
+                printf("%s %s\n",
+                    !hasRun ? "ERROR" : isEqual ? "OK   " : "DIFF ",
+                    tc.testSetPath.c_str());
+                fflush(stdout);
+            }
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+
+    printf("%d of %d test cases differ from the reference output.\n",
+        (int)nofFailed, (int)testCases.size());
+    return nofFailed == 0 ? 0 : 1;
+}
+
+// Test cases are declared in the outermost Makefile, one per line:
+// ./src/sim/sim --autorun <.tst> <reference .txt>
+static bool loadTestCases(const char *makefilePath, const std::string &resultDir,
+    std::vector<STestCase> &testCases)
+{
+    std::ifstream makefileStream(makefilePath);
+    if (!makefileStream.is_open()) {
+        std::cerr << "Failed to open " << makefilePath << std::endl;
+        return false;
+    }
+
+    std::string line;
+    while (getline(makefileStream, line)) {
+        std::istringstream lineStream(line);
+        std::string word;
+        while (lineStream >> word && word != "--autorun") {
+        }
+        STestCase tc;
+        if (!(lineStream >> tc.testSetPath >> tc.referencePath)) {
+            continue;
+        }
+        size_t slashIx = tc.referencePath.find_last_of('/');
+        tc.resultPath = resultDir + "/" + tc.referencePath.substr(slashIx + 1);
+        testCases.push_back(tc);
+    }
+    return true;
+}
+
+static bool runTestCase(const std::string &simBatchPath, const char *sweepPath,
+    int nofPredictionThreads, STestCase &tc)
+{
+    // The simulation is very verbose; we drop its console output.
+    posix_spawn_file_actions_t fileActions;
+    posix_spawn_file_actions_init(&fileActions);
+    posix_spawn_file_actions_addopen(&fileActions, 1, "/dev/null", O_WRONLY, 0);
+    posix_spawn_file_actions_addopen(&fileActions, 2, "/dev/null", O_WRONLY, 0);
+
+    std::vector<char *> args;
+    std::string predictionThreads = std::to_string(nofPredictionThreads);
+    args.push_back((char *)simBatchPath.c_str());
+    args.push_back((char *)"-j");
+    args.push_back((char *)predictionThreads.c_str());
+    if (sweepPath) {
+        args.push_back((char *)"-p");
+        args.push_back((char *)sweepPath);
+    }
+    args.push_back((char *)tc.testSetPath.c_str());
+    args.push_back((char *)tc.resultPath.c_str());
+    args.push_back(nullptr);
+
+    pid_t pid;
+    int err = posix_spawn(&pid, args[0], &fileActions, nullptr, args.data(), environ);
+    posix_spawn_file_actions_destroy(&fileActions);
+    if (err != 0) {
+        return false;
+    }
+
+    int status;
+    if (waitpid(pid, &status, 0) != pid) {
+        return false;
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static bool filesAreEqual(const std::string &path1, const std::string &path2)
+{
+    std::ifstream s1(path1, std::ios::binary);
+    std::ifstream s2(path2, std::ios::binary);
+    if (!s1.is_open() || !s2.is_open()) {
+        return false;
+    }
+    std::stringstream c1, c2;
+    c1 << s1.rdbuf();
+    c2 << s2.rdbuf();
+    return c1.str() == c2.str();
+}
+
+// Compares the alarm timelines: every alarm of one file must have an alarm
+// with the same level in the other file at most toleranceSec seconds apart.
+// The aircraft and the message are ignored, as alarms of the same level
+// can swap places. The other lines must be equal.
+static bool timelinesAreEqual(const std::string &path1, const std::string &path2,
+    int toleranceSec)
+{
+    std::string header1, header2;
+    std::vector<SAlarm> alarms1, alarms2;
+    if (!loadTimeline(path1, header1, alarms1) || !loadTimeline(path2, header2, alarms2)) {
+        return false;
+    }
+    return header1 == header2
+        && containsAlarms(alarms1, alarms2, toleranceSec)
+        && containsAlarms(alarms2, alarms1, toleranceSec);
+}
+
+// Alarm lines: <sec>;<aircraft>;<level>;<message>;<intensity>
+static bool loadTimeline(const std::string &path, std::string &header,
+    std::vector<SAlarm> &alarms)
+{
+    std::ifstream stream(path);
+    if (!stream.is_open()) {
+        return false;
+    }
+    std::string line;
+    while (getline(stream, line)) {
+        SAlarm alarm;
+        char aircraft[64];
+        if (sscanf(line.c_str(), "%d;%63[^;];%d;", &alarm.sec, aircraft, &alarm.level) == 3) {
+            alarms.push_back(alarm);
+        } else {
+            header += line + "\n";
+        }
+    }
+    return true;
+}
+
+static bool containsAlarms(const std::vector<SAlarm> &alarms,
+    const std::vector<SAlarm> &otherAlarms, int toleranceSec)
+{
+    for (const SAlarm &alarm : alarms) {
+        bool isFound = false;
+        for (const SAlarm &other : otherAlarms) {
+            if (other.level == alarm.level && abs(other.sec - alarm.sec) <= toleranceSec) {
+                isFound = true;
+                break;
+            }
+        }
+        if (!isFound) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void printUsageAndExit(const char *appName)
+{
+    fprintf(stderr, "usage: %s [-j <threads>] [-o <result dir>] [-s <sim-batch>] [-t <sec>]\n"
+        "    [-p <parameters>] [<Makefile>]\n", appName);
+    fprintf(stderr, "Runs all test cases declared in the Makefile in parallel (with sim-batch)\n");
+    fprintf(stderr, "and compares the results with the reference output files.\n");
+    fprintf(stderr, "With -t, only the alarm timelines are compared, with a tolerance of <sec>.\n");
+    fprintf(stderr, "With -p, sim-batch also writes the results of a parameter sweep (see\n");
+    fprintf(stderr, "sim-batch); they are not compared.\n");
+    exit(-1);
+}
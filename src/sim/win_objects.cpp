@@ -268,6 +268,14 @@ void Win_Objects::DisplayFlightPath(FlightPathConfig *fpc, int yPos)
         }
     }
 
+    // Filtered alarm level of the alarm service
+    if (fpc->alarmServiceLevel != ALARM_LEVEL_NONE) {
+        double rgba[4];
+        GetColorForAlarmLevel(fpc->alarmServiceLevel, rgba);
+        sprintf(buf, "(L%d)", (int)fpc->alarmServiceLevel);
+        DrawColorString2D(buf, 20, yPos + 110, 3.0, rgba[0], rgba[1], rgba[2]);
+    }
+
     // Alarm message
     double rgba[4];
     GetColorForAlarmLevel(fpc->alarmLevel, rgba);
@@ -39,14 +39,18 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifndef SIM_BATCH
 #ifdef __APPLE__
 #include <GLUT/glut.h>
 #else
 #include <GL/glut.h>
 #endif
+#endif
 
+#include <algorithm>
 #include <iostream>
 #include <map>
+#include <thread>
 
 #include "radio_link.h"
 #include "workspace.h"
@@ -58,9 +62,11 @@
 #include "time_range.h"
 #include "world_coords.h"
 
+#ifndef SIM_BATCH
 #include "win_objects.h"
 #include "win_time.h"
 #include "win_world.h"
+#endif
 
 #include "AlarmStateList.h"
 #include "CalculateOtherData.h"
@@ -68,17 +74,16 @@
 #include "FlightObjectList.h"
 #include "FlightObjectOrientation.h"
 #include "FlightPathExtrapolation.h"
+#include "InputRecorder.h"
 #include "Prediction.h"
 
 using namespace linalg;
+#ifndef SIM_BATCH
 using namespace gui;
-
-// From Prediction.c
-extern TVector sOwnFlightPath[T_MAX_SEC];
-extern TVector *sOtherFlightPath; // [20][T_MAX_SEC];
-extern uint32_t *sOtherFlightPathIdNr; // [20];
+#endif
 
 static Workspace *sWorkspace;
+static int sPredictionThreads = 0;
 
 WorldCoords worldCoords;
 TestSet *testSet = nullptr;
@@ -87,6 +92,8 @@ TimeRange tr;
 
 static void VectorTest(void);
 static void IgcTest(void);
+static void WriteInputRecording(void *user, const uint8_t *data, int size);
+static void InitSweepCapacities(TOcapCapacities *capacities);
 
 Workspace *Workspace::Instance()
 {
@@ -96,18 +103,43 @@ Workspace *Workspace::Instance()
     return sWorkspace;
 }
 
+void Workspace::SetPredictionThreads(int n)
+{
+    sPredictionThreads = n;
+}
+
 Workspace::Workspace()
 {
-    sOtherFlightPath = new TVector[FLIGHT_OBJECT_LIST_LENGTH * T_MAX_SEC];
-    sOtherFlightPathIdNr = new uint32_t[FLIGHT_OBJECT_LIST_LENGTH];
+    TOcapCapacities capacities;
+    ocapCapacitiesInitDefault(&capacities);
+#if PREDICTION_THREADS_MAX > 1
+    // The threads are started once with the context.
+    int n = sPredictionThreads > 0 ? sPredictionThreads : (int)std::thread::hardware_concurrency();
+    capacities.predictionThreads = std::max(1, std::min(n, PREDICTION_THREADS_MAX));
+#endif
+    size_t memorySize = ocapContextGetMemorySize(&capacities);
+    ocapContextMemory = new uint8_t[memorySize];
+    ocapContextInitWithMemory(&ocapContext, &capacities, ocapContextMemory, memorySize);
+
+    otherFlightPath = new TVector[capacities.flightObjects * T_MAX_SEC];
+    otherFlightPathIdNr = new uint32_t[capacities.flightObjects];
+    ocapContext.otherFlightPath = otherFlightPath;
+    ocapContext.otherFlightPathIdNr = otherFlightPathIdNr;
 }
 
 Workspace::~Workspace()
 {
-    delete[] sOtherFlightPath;
-    delete[] sOtherFlightPathIdNr;
-    sOtherFlightPath = nullptr;
-    sOtherFlightPathIdNr = nullptr;
+    ocapContextExit(&ocapContext);
+    ocapContext.otherFlightPath = nullptr;
+    ocapContext.otherFlightPathIdNr = nullptr;
+    delete[] otherFlightPath;
+    delete[] otherFlightPathIdNr;
+    otherFlightPath = nullptr;
+    otherFlightPathIdNr = nullptr;
+    delete[] ocapContextMemory;
+    ocapContextMemory = nullptr;
+    delete[] sweepContexts;
+    sweepContexts = nullptr;
 }
 
 void Workspace::Initialize(std::string pathToTestSet, bool isAutoRun, bool isRealTime, std::string resultFile)
@@ -139,6 +171,17 @@ void Workspace::Initialize(std::string pathToTestSet, bool isAutoRun, bool isRea
     // Create the world coordinates.
     worldCoords.setLonLatAltRanges(lonMinDeg, lonMaxDeg, latMinDeg, latMaxDeg, altMinMtr);
 
+#ifdef SIM_BATCH
+    tr.SetFrom(0, false);
+    tr.SetTo(100, false);
+
+    // Without an objects window, we select the first aircraft ourselves
+    // (as Win_Objects does in autorun mode).
+    FlightPathConfig *fpcFirst = testSet->GetFlightPathAtIndex(0);
+    if (fpcFirst) {
+        fpcFirst->isSelected = true;
+    }
+#else
     // Simulation window
     Win_World *winWorld = Win_World::Instance();
     winWorld->SetWorldCoords(&worldCoords);
@@ -157,13 +200,36 @@ void Workspace::Initialize(std::string pathToTestSet, bool isAutoRun, bool isRea
     Win_Objects *winObjects = Win_Objects::Instance();
     winObjects->SetTestSet(testSet);
     winObjects->SetTimeRange(&tr);
+#endif
 }
 
 void Workspace::PostRedisplayAll()
 {
+#ifndef SIM_BATCH
     Win_Time::Instance()->PostRedisplay();
     Win_World::Instance()->PostRedisplay();
     Win_Objects::Instance()->PostRedisplay();
+#endif
+}
+
+void Workspace::RunAutoRun()
+{
+    // Same sequence as the GLUT timer in Win_Time::TimerFunc,
+    // but without waiting between the steps.
+    tr.SetFrom(testSet->GetStartTimeAutoRunSec(), false);
+    tr.SetTo(testSet->GetStartTimeAutoRunSec() + 1, false);
+    StartCollisionWarning();
+
+    while (tr.GetTo() < testSet->GetEndTimeAutoRunSec()) {
+        double toSec = tr.GetTo();
+        tr.SetTo(toSec + 1, false);
+        // Stop if the time range is clamped at the end of the data set.
+        if (tr.GetTo() <= toSec) {
+            break;
+        }
+    }
+
+    StopCollisionWarning();
 }
 
 bool Workspace::IsAutoRun()
@@ -186,10 +252,18 @@ void Workspace::StartCollisionWarning()
     printf("--- StartCollisionWarning\n");
     collisionWarningLastTimeMs = 0;
 
+    // Record the input of the context from its start on.
+    if (!inputRecordingFileName.empty() && !inputRecordingFile) {
+        inputRecordingFile = fopen(inputRecordingFileName.c_str(), "wb");
+        if (inputRecordingFile) {
+            inputRecorderStart(&ocapContext, WriteInputRecording, inputRecordingFile);
+        }
+    }
+
     // Configure the prediction logic.
 
     // Double width at end of extrapolation; double and 4x width for L2 and L1.
-    predictionInit(30, 2, 4);
+    predictionInit(&ocapContext, 30, 2, 4);
 
     // Create the result file.
 
@@ -199,6 +273,34 @@ void Workspace::StartCollisionWarning()
     fprintf(collisionResultFile, "selected aircraft           = %s\n",
         !fpcSelected ? "none" : fpcSelected->GetIdentifier().c_str());
 
+    // Same for each parameter set of the sweep, with fresh alarm states
+    // and alarm services.
+    TOcapCapacities sweepCapacities;
+    InitSweepCapacities(&sweepCapacities);
+    size_t sweepMemorySize = ocapContextGetMemorySize(&sweepCapacities);
+    std::string resultBase = collisionResultFileName;
+    size_t dotIx = resultBase.find_last_of('.');
+    if (dotIx != std::string::npos && dotIx > resultBase.find_last_of('/') + 1) {
+        resultBase = resultBase.substr(0, dotIx);
+    }
+    for (int j = 0; j < GetNofSweepSets(); j++) {
+        TOcapContext *setCtx = &sweepContexts[j];
+        ocapContextInitWithMemory(setCtx, &sweepCapacities,
+            &sweepContextMemory[j * sweepMemorySize], sweepMemorySize);
+        float *p = &sweepParameters[3 * j];
+        predictionInit(setCtx, p[0], p[1], p[2]);
+
+        std::string fileName = resultBase + "_p" + std::to_string(j + 1) + ".txt";
+        FILE *f = fopen(fileName.c_str(), "w");
+        if (f) {
+            fprintf(f, "test set                    = %s\n", testSet->GetName().c_str());
+            fprintf(f, "selected aircraft           = %s\n",
+                !fpcSelected ? "none" : fpcSelected->GetIdentifier().c_str());
+            fprintf(f, "prediction parameters       = %g %g %g\n", p[0], p[1], p[2]);
+        }
+        sweepResultFiles[j] = f;
+    }
+
     // Let the selected aircraft start the collision warning algorithm.
     FlightPathConfig *fpc = testSet->GetSelectedFlightPath();
     if (fpc) {
@@ -215,6 +317,21 @@ void Workspace::StopCollisionWarning()
         fclose(collisionResultFile);
         collisionResultFile = nullptr;
     }
+    for (FILE *&f : sweepResultFiles) {
+        if (f) {
+            fclose(f);
+            f = nullptr;
+        }
+    }
+    for (int j = 0; j < GetNofSweepSets(); j++) {
+        ocapContextExit(&sweepContexts[j]);
+    }
+    if (inputRecordingFile) {
+        inputRecorderStop(&ocapContext);
+        fclose(inputRecordingFile);
+        inputRecordingFile = nullptr;
+        inputRecordingFileName.clear();
+    }
 }
 
 bool Workspace::IsCollisionWarningRunning()
@@ -248,8 +365,8 @@ void Workspace::YieldCollisionWarning(long timeMs)
     RadioLink::Instance()->YieldDistribution(oldMsEnd);
 
     // For development only
-    for (int i = 0; i < FLIGHT_OBJECT_LIST_LENGTH; i++) {
-        sOtherFlightPathIdNr[i] = 0;
+    for (int i = 0; i < ocapContext.flightObjectCapacity; i++) {
+        otherFlightPathIdNr[i] = 0;
     }
 
     // Clear alarm message on all aircraft.
@@ -258,6 +375,10 @@ void Workspace::YieldCollisionWarning(long timeMs)
         FlightPathConfig *fpc = testSet->GetFlightPathAtIndex(i);
         fpc->alarmMessage = "";
         fpc->alarmLevel = ALARM_LEVEL_NONE;
+        fpc->alarmServiceLevel = ALARM_LEVEL_NONE;
+    }
+    for (SAlarmInformation &info : sweepAlarmInformation) {
+        info = SAlarmInformation();
     }
 
     // Run prediction for selected aircraft, broadcast packets for all aircraft.
@@ -276,7 +397,9 @@ void Workspace::YieldCollisionWarning(long timeMs)
             pt->startTimeMs = timeMs;
             pt->isSelected = true;
             for (int i = 0; i < T_MAX_SEC; i++) {
-                pt->positionsMtr[i].Set(sOwnFlightPath[i].x, sOwnFlightPath[i].y, sOwnFlightPath[i].z);
+                TVector pos;
+                flightPathExtrapolationGetPathPosition(&ocapContext.ownFlightPath.pos, i, &pos);
+                pt->positionsMtr[i].Set(pos.x, pos.y, pos.z);
             }
             fpc->SetPredictedTrace(pt);
         }
@@ -313,13 +436,22 @@ void Workspace::YieldCollisionWarning(long timeMs)
                 fpc->alarmMessage.c_str(), fpc->alarmIntensity);
         }
     }
+    for (int j = 0; j < GetNofSweepSets(); j++) {
+        SAlarmInformation &info = sweepAlarmInformation[j];
+        if (info.alarmLevel == ALARM_LEVEL_NONE || !sweepResultFiles[j]) {
+            continue;
+        }
+        fprintf(sweepResultFiles[j], "%7d;%s;%d;%s;%d\n",
+            newSec, info.fpcOther->GetIdentifier().c_str(), (int)info.alarmLevel,
+            info.alarmMessage.c_str(), info.alarmIntensity);
+    }
 
     // Store predicted path for non-selected aircraft.
-    for (int i = 0; i < FLIGHT_OBJECT_LIST_LENGTH; i++) {
-        if (!sOtherFlightPathIdNr[i]) {
+    for (int i = 0; i < ocapContext.flightObjectCapacity; i++) {
+        if (!otherFlightPathIdNr[i]) {
             continue;
         }
-        uint32_t curIdNr = sOtherFlightPathIdNr[i];
+        uint32_t curIdNr = otherFlightPathIdNr[i];
         FlightPathConfig *fpc = testSet->GetFlightPathByIdNr(curIdNr);
         if (!fpc) {
             continue;
@@ -332,9 +464,9 @@ void Workspace::YieldCollisionWarning(long timeMs)
         int baseOffset = T_MAX_SEC * i;
         for (int t = 0; t < T_MAX_SEC; t++) {
             pt->positionsMtr[t].Set(
-                sOtherFlightPath[baseOffset + t].x,
-                sOtherFlightPath[baseOffset + t].y,
-                sOtherFlightPath[baseOffset + t].z);
+                otherFlightPath[baseOffset + t].x,
+                otherFlightPath[baseOffset + t].y,
+                otherFlightPath[baseOffset + t].z);
         }
         fpc->SetPredictedTrace(pt);
     }
@@ -345,10 +477,68 @@ FlightPathConfig *Workspace::GetFlightPathByIdNr(uint32_t idNr)
     return testSet->GetFlightPathByIdNr(idNr);
 }
 
+TOcapContext *Workspace::GetOcapContext()
+{
+    return &ocapContext;
+}
+
+bool Workspace::LoadPredictionSweep(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return false;
+    }
+    sweepParameters.clear();
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        float k, facLevel2, facLevel1;
+        if (line[0] == '#' || sscanf(line, "%f %f %f", &k, &facLevel2, &facLevel1) != 3) {
+            continue;
+        }
+        sweepParameters.push_back(k);
+        sweepParameters.push_back(facLevel2);
+        sweepParameters.push_back(facLevel1);
+    }
+    fclose(f);
+
+    // The contexts are initialized in StartCollisionWarning.
+    int n = GetNofSweepSets();
+    TOcapCapacities capacities;
+    InitSweepCapacities(&capacities);
+    delete[] sweepContexts;
+    sweepContexts = new TOcapContext[n]();
+    sweepContextMemory.assign(n * ocapContextGetMemorySize(&capacities), 0);
+    sweepResultFiles.assign(n, nullptr);
+    sweepAlarmInformation.assign(n, SAlarmInformation());
+    return true;
+}
+
+int Workspace::GetNofSweepSets()
+{
+    return (int)sweepParameters.size() / 3;
+}
+
+void Workspace::SetInputRecording(std::string path)
+{
+    inputRecordingFileName = path;
+}
+
+TOcapContext *Workspace::GetSweepContexts()
+{
+    return sweepContexts;
+}
+
+SAlarmInformation *Workspace::GetSweepAlarmInformation(int ix)
+{
+    return &sweepAlarmInformation[ix];
+}
+
 void Workspace::SetReplayPackets(bool r)
 {
     isReplayPackets = r;
+#ifndef SIM_BATCH
     Win_Time::Instance()->PostRedisplay();
+#endif
 }
 
 bool Workspace::GetReplayPackets()
@@ -359,10 +549,29 @@ bool Workspace::GetReplayPackets()
 void Workspace::SetUseIConspicuity2(bool r)
 {
     isIConspicuity2 = r;
+#ifndef SIM_BATCH
     Win_Time::Instance()->PostRedisplay();
+#endif
 }
 
 bool Workspace::GetUseIConspicuity2()
 {
     return isIConspicuity2;
 }
+
+// Sink of the input recorder: appends to the file.
+static void WriteInputRecording(void *user, const uint8_t *data, int size)
+{
+    fwrite(data, 1, size, (FILE *)user);
+}
+
+// Capacities of the context of a parameter set of the sweep: it only
+// holds our own flight path and the alarm states.
+static void InitSweepCapacities(TOcapCapacities *capacities)
+{
+    ocapCapacitiesInitDefault(capacities);
+    capacities->flightObjects = 1;
+    capacities->rxQueueLength = 0;
+    capacities->alarmServiceEntries = 0;
+    capacities->alarmEventQueueLength = 0;
+}
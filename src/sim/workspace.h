@@ -36,6 +36,7 @@
 #define __WORKSPACE_H__ 1
 
 #include "flight_path_config.h"
+#include "OcapContext.h"
 #include <stdio.h>
 #include <vector>
 
@@ -43,6 +44,10 @@ class Workspace {
 public:
     static Workspace *Instance();
 
+    // Number of threads of the parallel prediction (make batch-parallel),
+    // 0 for one per core. Call before the first call of Instance().
+    static void SetPredictionThreads(int n);
+
 private:
     Workspace();
 
@@ -53,6 +58,10 @@ public:
 
     void PostRedisplayAll();
 
+    // Runs the autorun time window of the loaded test set in a tight loop
+    // and writes the result file (batch mode, no GUI).
+    void RunAutoRun();
+
     bool IsAutoRun();
     bool IsRealTime();
 
@@ -66,6 +75,24 @@ public:
 
     FlightPathConfig *GetFlightPathByIdNr(uint32_t idNr);
 
+    // The libocap instance of the selected aircraft.
+    TOcapContext *GetOcapContext();
+
+    // Parameter sweep: loads prediction parameter sets (one "k facLevel2
+    // facLevel1" per line) that are evaluated in addition to the default
+    // parameters, each with its own result file <result>_p<n>.txt.
+    // Call before the collision warning is started.
+    bool LoadPredictionSweep(const char *path);
+    int GetNofSweepSets();
+    // Contexts holding the parameters and alarm states of the sets.
+    TOcapContext *GetSweepContexts();
+    SAlarmInformation *GetSweepAlarmInformation(int ix);
+
+    // Records the input of the libocap context into a file
+    // (InputRecorder.h), for ocap-replay in ../libocap. Call before the
+    // collision warning is started for the first time.
+    void SetInputRecording(std::string path);
+
     void SetReplayPackets(bool r);
     bool GetReplayPackets();
     void SetUseIConspicuity2(bool r);
@@ -82,6 +109,25 @@ private:
     
     std::string collisionResultFileName;
     FILE *collisionResultFile = nullptr;
+
+    TOcapContext ocapContext;
+    // Memory of the context (tables with the default capacities).
+    uint8_t *ocapContextMemory = nullptr;
+    // Predicted flight paths of the other aircraft, provided by libocap.
+    TVector *otherFlightPath = nullptr; // [flightObjectCapacity][T_MAX_SEC]
+    uint32_t *otherFlightPathIdNr = nullptr; // [flightObjectCapacity]
+
+    // Parameter sweep: parameters (k, facLevel2, facLevel1), contexts,
+    // their memory, result files and alarm information of the sets.
+    std::vector<float> sweepParameters;
+    TOcapContext *sweepContexts = nullptr;
+    std::vector<uint8_t> sweepContextMemory;
+    std::vector<FILE *> sweepResultFiles;
+    std::vector<SAlarmInformation> sweepAlarmInformation;
+
+    // Input recording: file name (empty if none) and file.
+    std::string inputRecordingFileName;
+    FILE *inputRecordingFile = nullptr;
 };
 
 #endif // __WORKSPACE_H__